@@ -16,10 +16,10 @@ int foo(int X1, int X2) {
     X2 = X1 + X1;
     X1 = f(X2, X2);  /* function call */
     /*
-     * Note: this function call is currently not yet analyzed in the
-     * implementation of pymwp, and as such the two examples
-     * example15_a.c/example15_b.c do not produce comparable matrices.
-     * Once analysis of function calls is fully implemented, the matrices
-     * will be comparable.
+     * Note: this function call is analyzed with the summary of f: the
+     * choices of f that lead to infinity become choices of this call.
+     * The matrices of example15_a.c/example15_b.c differ, since the
+     * variables of f are not variables of foo, but both require
+     * choice 2 for the loop of f.
      */
 }
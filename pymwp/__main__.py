@@ -13,6 +13,9 @@ applying the optional flags.
 
 The available arguments are specified below in `_parse_args` -method.
 
+Calling `pymwp serve` instead starts a persistent analysis server, see
+`serve` -method.
+
 This method also initializes the program logger that displays debugging
 information on the screen. The logger default to log level DEBUG. Analysis
 output can be muted by specifying command line argument `--silent`.
@@ -23,13 +26,22 @@ import logging
 import sys
 from typing import List, Optional
 
+from . import backend, workers
 from .analysis import Analysis
+from .backend import BACKENDS, DEFAULT
 from .file_io import default_file_out, parse
+from .server import Server
+from .stats import Stats
+from .trace import Trace
 from .version import __version__
 
 
 def main():
     """Implementation of MWP analysis on C code in Python."""
+    if sys.argv[1:2] == ['serve']:
+        serve(sys.argv[2:])
+        return
+
     parser = argparse.ArgumentParser(prog='pymwp', description=main.__doc__)
     args = __parse_args(parser)
 
@@ -39,10 +51,68 @@ def main():
 
     log_level = logging.FATAL - (0 if args.silent else 40)
     __setup_logger(log_level, args.logfile)
-    file_out = args.out or default_file_out(args.file)
+    backend.use(args.backend)
+    workers.use(args.jobs)
+    file_out = args.out or default_file_out(
+        args.file, 'ndjson' if args.stream else 'json')
+
+    stats = Stats() if args.stats else None
+    trace = Trace() if args.trace else None
+    for collector in (stats, trace):
+        if collector:
+            collector.start()
+    try:
+        ast = parse(args.file, not args.no_cpp, args.cpp, args.cpp_args)
+        Analysis.run(
+            ast, file_out, args.no_save, args.no_eval, args.stream, stats)
+        if stats and args.no_save:
+            stats.show()
+    finally:
+        if trace:
+            trace.stop()
+            trace.save(args.trace)
+
+
+def serve(argv: Optional[List] = None):
+    """Run a persistent analysis server, see pymwp/server.py."""
+    parser = argparse.ArgumentParser(
+        prog='pymwp serve', description=serve.__doc__)
+    parser.add_argument(
+        "--socket",
+        action="store",
+        help="listen on this Unix domain socket instead of stdin/stdout",
+    )
+    parser.add_argument(
+        '--cpp',
+        action='store',
+        default='gcc',
+        help='path to C pre-processor on your system (default: gcc)',
+    )
+    parser.add_argument(
+        '--cpp-args',
+        action='store',
+        default='-E',
+        help='arguments to pass to C pre-processor (default: -E)',
+    )
+    parser.add_argument(
+        "--no-cpp",
+        action='store_true',
+        help="disable execution of C pre-processor on inputs"
+    )
+    parser.add_argument(
+        "--logfile",
+        action="store",
+        help="save log messages into a file",
+    )
+    parser.add_argument(
+        "--silent",
+        action='store_true',
+        help="silence logging: only fatal errors will display"
+    )
+    args = parser.parse_args(argv)
 
-    ast = parse(args.file, not args.no_cpp, args.cpp, args.cpp_args)
-    Analysis.run(ast, file_out, args.no_save, args.no_eval)
+    __setup_logger(logging.FATAL - (0 if args.silent else 20), args.logfile)
+    Server(args.cpp, args.cpp_args, not args.no_cpp).serve(args.socket)
 
 
 def __parse_args(
@@ -92,6 +162,38 @@ def __parse_args(
         action='store_true',
         help="skip writing result to file"
     )
+    parser.add_argument(
+        "--backend",
+        choices=sorted(BACKENDS),
+        default=DEFAULT,
+        help=f"polynomial representation (default: {DEFAULT})"
+    )
+    parser.add_argument(
+        "--jobs",
+        type=int,
+        default=1,
+        help="number of worker processes for independent functions, long "
+             "function bodies and large matrix products (default: 1)"
+    )
+    parser.add_argument(
+        "--stream",
+        action='store_true',
+        help="write each function result as a JSON line as soon as "
+             "it is analyzed"
+    )
+    parser.add_argument(
+        "--stats",
+        action='store_true',
+        help="record time and call count of analysis phases, per function, "
+             "and save them next to the result, or print them with --no-save"
+    )
+    parser.add_argument(
+        "--trace",
+        action="store",
+        metavar="FILE",
+        help="write a timeline of the analysis to FILE in Chrome "
+             "trace-event format"
+    )
     parser.add_argument(
         "--silent",
         action='store_true',
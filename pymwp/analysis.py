@@ -1,14 +1,24 @@
 import logging
-from typing import List, Tuple, Optional, Union, Dict
+from typing import List, Tuple, Optional, Union, Dict, Iterator
 from pycparser import c_ast
 from pycparser.c_ast import Node, Assignment, If, While, For, Compound, \
-    ParamList, FuncCall
+    ParamList, FuncCall, FuncDef
 
+from . import backend, parallel, workers
+from .blocks import BlockRelation
+from .calls import CallGraph, Summary, SummaryTable, pack_result, \
+    unpack_result
 from .relation_list import RelationList, Relation
 from .polynomial import Polynomial
 from .monomial import Monomial
-from .delta_graphs import DeltaGraph
-from .file_io import save_relation
+from .infinity import InfinityStore
+from .mdd import MANAGER
+from .memo import RelationCache, CACHED
+from .planner import compose_chain
+from .variables import VariableTable
+from .file_io import save_relation, open_stream, write_relation, \
+    RESULT_TYPE
+from .stats import Stats, FUNCTION, span, timed
 
 logger = logging.getLogger(__name__)
 
@@ -19,7 +29,8 @@ class Analysis:
     @staticmethod
     def run(
             ast: c_ast, file_out: str = None,
-            no_save: bool = False, no_eval: bool = False
+            no_save: bool = False, no_eval: bool = False,
+            stream: bool = False, stats: Optional[Stats] = None
     ) -> Union[Dict, Tuple[Relation, List[List[int]], bool]]:
         """Run MWP analysis on specified input file.
 
@@ -28,6 +39,17 @@ class Analysis:
             file_out: where to store result
             no_save: Set true when analysis result should not be saved to file
             no_eval: Skip evaluation phase
+            stream: Write result of each function to `file_out` as soon as
+                it has been analyzed, as newline-delimited JSON (see
+                [`write_relation`](file_io.md#pymwp.file_io.write_relation)).
+                Functions are then written in the order they are analyzed,
+                callees first. Results of previously analyzed functions are
+                not retained in memory: the returned dictionary only
+                contains the last analyzed function.
+            stats: Record per-function phase statistics into this object.
+                Unless saving is disabled, statistics are also written to
+                a file next to `file_out` (see
+                [`Stats.file_name`](stats.md#pymwp.stats.Stats.file_name)).
 
         Returns:
               - Computed relation,
@@ -38,62 +60,248 @@ class Analysis:
         logger.debug("starting analysis")
         single_function = len(ast.ext) == 1
         result, function_name = {}, ''
+        out_stream = open_stream(file_out) \
+            if stream and not no_save else None
+        stop_stats = stats is not None and not stats.active
+        if stop_stats:
+            stats.start()
+
+        graph = CallGraph(list(ast))
+        try:
+            for name, analyzed in Analysis.analyze_program(graph, no_eval):
+                function_name = name
+                if out_stream:
+                    result.clear()
+                result[name] = analyzed
+                if out_stream:
+                    write_relation(out_stream, name, analyzed)
+        finally:
+            if out_stream:
+                out_stream.close()
+        if not out_stream:
+            result = {name: result[name] for name in graph.functions}
 
-        for ast_ext in ast:
+        # save result to file unless explicitly disabled
+        if not no_save and not stream:
+            save_relation(file_out, result)
+
+        if stats is not None:
+            if stop_stats:
+                stats.stop()
+            if not no_save:
+                stats.save(Stats.file_name(file_out))
+
+        # return results to caller
+        return result[function_name] if single_function else result
+
+    @staticmethod
+    def analyze_program(graph: CallGraph, no_eval: bool = False) \
+            -> Iterator[Tuple[str, RESULT_TYPE]]:
+        """Analyze all functions of a translation unit.
+
+        Callees are analyzed before their callers, and calls are analyzed
+        with the summaries of the functions analyzed so far, see
+        [`calls`](calls.md).
+
+        Arguments:
+            graph: call graph of the translation unit
+            no_eval: Skip evaluation phase
+
+        Yields:
+            Name and result of each function, in analysis order.
+        """
+        with SummaryTable() as summaries:
+            for level in graph.levels():
+                for name, analyzed, summary in Analysis.analyze_level(
+                        graph, level, no_eval):
+                    summaries[name] = summary
+                    yield name, analyzed
+
+    @staticmethod
+    def analyze_level(graph: CallGraph, level: List[List[str]],
+                      no_eval: bool = False) \
+            -> List[Tuple[str, RESULT_TYPE, Summary]]:
+        """Analyze the components of one level of the call graph.
+
+        Components of a level do not call each other; with more than one
+        job, they are analyzed in worker processes, which receive the
+        summaries of the current table.
+
+        Arguments:
+            graph: call graph of the translation unit
+            level: components, see
+                [`CallGraph.levels`](calls.md#pymwp.calls.CallGraph.levels)
+            no_eval: Skip evaluation phase
+
+        Returns:
+            Name, result and summary of each function, by component.
+        """
+        components = [[graph.functions[name] for name in component]
+                      for component in level]
+        if workers.jobs() == 1 or len(components) == 1:
+            return [item for functions in components for item in
+                    Analysis.analyze_component(functions, no_eval)]
+        summaries = dict(SummaryTable.current or {})
+        tasks = [workers.pool().submit(
+            Analysis.analyze_packed, backend.name(), functions, summaries,
+            no_eval) for functions in components]
+        return [(name, unpack_result(packed), summary)
+                for task in tasks for name, packed, summary in task.result()]
+
+    @staticmethod
+    def analyze_component(functions: List[FuncDef], no_eval: bool = False) \
+            -> List[Tuple[str, RESULT_TYPE, Summary]]:
+        """Analyze a strongly connected component of the call graph.
+
+        Calls use the summaries of the current table; the summaries of
+        these functions are returned rather than added to it, so calls
+        between them are not summarized.
+
+        Arguments:
+            functions: mutually recursive function definitions
+            no_eval: Skip evaluation phase
+
+        Returns:
+            Name, result and summary of each function.
+        """
+        summaries = {}
+        results = [Analysis.analyze_function(function, no_eval, summaries)
+                   for function in functions]
+        return [(f.decl.name, result, summaries[f.decl.name])
+                for f, result in zip(functions, results)]
+
+    @staticmethod
+    def analyze_packed(name: str, functions: List[FuncDef],
+                       summaries: Dict[str, Summary], no_eval: bool) \
+            -> List[Tuple[str, tuple, Summary]]:
+        """Analyze a component in a worker process, see
+        [`analyze_component`](analysis.md#pymwp.analysis.Analysis
+        .analyze_component).
+
+        Arguments:
+            name: polynomial backend name
+            functions: mutually recursive function definitions
+            summaries: summaries of the functions they may call
+            no_eval: Skip evaluation phase
+
+        Returns:
+            Name, encoded result, see
+                [`pack_result`](calls.md#pymwp.calls.pack_result), and
+                summary of each function.
+        """
+        if backend.name() != name:
+            backend.use(name)
+        with SummaryTable(summaries):
+            return [(function_name, pack_result(result), summary)
+                    for function_name, result, summary in
+                    Analysis.analyze_component(functions, no_eval)]
+
+    @staticmethod
+    def analyze_function(
+            function: FuncDef, no_eval: bool = False,
+            summaries: Optional[Dict[str, Summary]] = None
+    ) -> RESULT_TYPE:
+        """Run MWP analysis on one function definition.
+
+        Arguments:
+            function: function definition AST node
+            no_eval: Skip evaluation phase
+            summaries: when given, the [summary](calls.md#pymwp.calls
+                .Summary) of the function is stored in it, by name
+
+        Returns:
+              - Computed relation,
+              - list of non-infinity choices
+              - infinite/not infinite (boolean flag)
+        """
+        function_name = function.decl.name
+        # decision diagrams of this function are released at the end
+        mark = MANAGER.mark()
+        with span(FUNCTION, name=function_name):
             choices = [0, 1, 2]
             index, combinations = 0, []
-            function_name = ast_ext.decl.name
-            function_body = ast_ext.body
-            args = ast_ext.decl.type.args
+            function_body = function.body
+            args = function.decl.type.args
             variables = Analysis.find_variables(function_body, args)
-            logger.debug(f"variables of {function_name}: {variables}")
+            logger.debug("variables of %s: %s", function_name, variables)
             evaluated = False
 
-            relations = RelationList.identity(variables=variables)
             total = len(function_body.block_items)
             delta_infty = False
-            dg = DeltaGraph()
-
-            for i, node in enumerate(function_body.block_items):
-                logger.debug(f'computing relation...{i} of {total}')
-                index, rel_list, delta_infty = Analysis \
-                    .compute_relation(index, node, dg)
-                if delta_infty:
-                    break
-                logger.debug(f'computing composition...{i} of {total}')
-                relations.composition(rel_list)
-
-            # skip evaluation when delta graph has detected infinity
+            store = InfinityStore()
+
+            # relations of this function share one table of variables;
+            # statements are composed into independent blocks, and
+            # repeated statements are analyzed once
+            with VariableTable(variables), \
+                    RelationCache(function_body.block_items):
+                relations = RelationList(
+                    relation_list=[BlockRelation(variables, store=store)])
+                # long bodies are composed in parallel, after the loop
+                deferred = [] if parallel.worthwhile(total) else None
+                for i, node in enumerate(function_body.block_items):
+                    with span('statement', index=i,
+                              type=type(node).__name__):
+                        logger.debug(
+                            'computing relation...%d of %d', i, total)
+                        index, rel_list, delta_infty = Analysis \
+                            .compute_relation(index, node, store)
+                        if delta_infty:
+                            break
+                        if deferred is not None:
+                            deferred.append(rel_list)
+                            continue
+                        logger.debug(
+                            'computing composition...%d of %d', i, total)
+                        relations.composition(rel_list)
+                if deferred and not delta_infty:
+                    logger.debug('composing %d statements in parallel',
+                                 len(deferred))
+                    relations.composition(parallel.compose_tree(deferred))
+                relations = RelationList(relation_list=[
+                    rel.relation() for rel in relations.relations])
+
+            # skip evaluation when infinity store has detected infinity
             # or caller has manually disabled evaluation
             if not delta_infty and not no_eval:
-                combinations = relations.first.eval(choices, index)
+                combinations = relations.first.eval(choices, index, store)
                 evaluated = True
 
             # the evaluation is infinite when either of these conditions holds:
             infinite = delta_infty or (
-                        relations.first.variables and index > 0 and
-                        evaluated and not combinations.valid)
+                    relations.first.variables and index > 0 and
+                    evaluated and not combinations.valid)
+
+            if summaries is not None:
+                summaries[function_name] = Summary.of(
+                    function, None if infinite else relations.first,
+                    index, store, infinite)
 
             # record and display results
             if infinite:
-                result[function_name] = None, None, True
-                logger.info(f'RESULT: {function_name} is infinite')
-            else:
-                result[function_name] = relations.first, combinations, False
-                logger.info(f'\nMATRIX{relations}')
-                if not evaluated:
-                    logger.info('Skipped evaluation')
-                else:
-                    logger.info(f'CHOICES: {combinations.valid}')
+                MANAGER.release(mark)
+                logger.info('RESULT: %s is infinite', function_name)
+                return None, None, True
 
-        # save result to file unless explicitly disabled
-        if not no_save:
-            save_relation(file_out, result)
+            MANAGER.release(mark, Analysis.polynomials(relations.first))
 
-        # return results to caller
-        return result[function_name] if single_function else result
+            logger.info('\nMATRIX%s', relations)
+            if not evaluated:
+                logger.info('Skipped evaluation')
+            else:
+                logger.info('CHOICES: %s', combinations.valid)
+            return relations.first, combinations, False
 
     @staticmethod
+    def polynomials(relation: Relation) -> List:
+        """Polynomials of a relation whose matrix is not kept as
+        [scalars](scalars.md); scalars use no decision diagram."""
+        if relation.scalars is not None:
+            return []
+        return [poly for row in relation.matrix for poly in row]
+
+    @staticmethod
+    @timed('find_variables')
     def find_variables(
             function_body: Compound, param_list: Optional[ParamList]
     ) -> List[str]:
@@ -136,15 +344,40 @@ class Analysis:
         return variables
 
     @staticmethod
-    def compute_relation(index: int, node: Node, dg: DeltaGraph) \
+    @timed('compute_relation')
+    def compute_relation(index: int, node: Node, store: InfinityStore) \
             -> Tuple[int, RelationList, bool]:
         """Create a relation list corresponding for all possible matrices
         of an AST node.
 
+        While a [`RelationCache`](memo.md#pymwp.memo.RelationCache) is
+        active, structurally equal compound statements are analyzed once,
+        and their relations are then relocated to the current delta index.
+
+        Arguments:
+            index: delta index
+            node: AST node to analyze
+            store: [choices leading to infinity](infinity.md)
+
+        Returns:
+            Updated index value, relation list, and an exit flag.
+        """
+        cache = RelationCache.current
+        if cache is None or not isinstance(node, CACHED):
+            return Analysis.analyze_node(index, node, store)
+        return cache.relation(index, node, store, Analysis.analyze_node)
+
+    @staticmethod
+    def analyze_node(index: int, node: Node, store: InfinityStore) \
+            -> Tuple[int, RelationList, bool]:
+        """Analyze an AST node by its type, see
+        [`compute_relation`](analysis.md#pymwp.analysis.Analysis
+        .compute_relation).
+
         Arguments:
             index: delta index
             node: AST node to analyze
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
@@ -155,7 +388,7 @@ class Analysis:
         if isinstance(node, c_ast.Decl):
             return index, RelationList(), False
         if isinstance(node, FuncCall):
-            return Analysis.func_call(index)
+            return Analysis.func_call(index, node, store)
         if isinstance(node, c_ast.Assignment):
             if isinstance(node.rvalue, c_ast.BinaryOp):
                 return Analysis.binary_op(index, node)
@@ -166,17 +399,17 @@ class Analysis:
             if isinstance(node.rvalue, c_ast.ID):
                 return Analysis.id(index, node)
             if isinstance(node.rvalue, FuncCall):
-                return Analysis.func_call(index)
+                return Analysis.func_call(index, node, store)
         if isinstance(node, c_ast.If):
-            return Analysis.if_(index, node, dg)
+            return Analysis.if_(index, node, store)
         if isinstance(node, c_ast.While):
-            return Analysis.while_(index, node, dg)
+            return Analysis.while_(index, node, store)
         if isinstance(node, c_ast.For):
-            return Analysis.for_(index, node, dg)
+            return Analysis.for_(index, node, store)
         if isinstance(node, c_ast.Compound):
-            return Analysis.compound_(index, node, dg)
+            return Analysis.compound_(index, node, store)
 
-        logger.debug(f"uncovered case! type: {type(node)}")
+        logger.debug("uncovered case! type: %s", type(node))
 
         return index, RelationList(), False
 
@@ -206,8 +439,8 @@ class Analysis:
         # y | m   m
         vector = [
             # because x != y
-            Polynomial([Monomial('o')]),
-            Polynomial([Monomial('m')])
+            backend.polynomial([Monomial('o')]),
+            backend.polynomial([Monomial('m')])
         ]
 
         # build a list of unique variables
@@ -294,14 +527,14 @@ class Analysis:
         return index, RelationList.identity(variables), False
 
     @staticmethod
-    def if_(index: int, node: If, dg: DeltaGraph) \
+    def if_(index: int, node: If, store: InfinityStore) \
             -> Tuple[int, RelationList, bool]:
         """Analyze an if statement.
 
         Arguments:
             index: delta index
             node: if-statement AST node
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
@@ -310,11 +543,11 @@ class Analysis:
         true_relation, false_relation = RelationList(), RelationList()
 
         index, exit_ = Analysis.if_branch(
-            node.iftrue, index, true_relation, dg)
+            node.iftrue, index, true_relation, store)
         if exit_:
             return index, true_relation, True
         index, exit_ = Analysis.if_branch(
-            node.iffalse, index, false_relation, dg)
+            node.iffalse, index, false_relation, store)
         if exit_:
             return index, false_relation, True
 
@@ -323,7 +556,8 @@ class Analysis:
 
     @staticmethod
     def if_branch(
-            node: If, index: int, relation_list: RelationList, dg: DeltaGraph
+            node: If, index: int, relation_list: RelationList,
+            store: InfinityStore
     ) -> Tuple[int, bool]:
         """Analyze `if` or `else` branch of a conditional statement.
 
@@ -339,89 +573,86 @@ class Analysis:
             node: AST if statement branch node
             index: current delta index value
             relation_list: current relation list state
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
         """
         if node is not None:
             # when branch has braces
-            if hasattr(node, 'block_items'):
-                for child in node.block_items:
-                    index, rel_list, exit_ = Analysis.compute_relation(
-                        index, child, dg)
-                    if exit_:
-                        return index, exit_
-                    relation_list.composition(rel_list)
-            else:
+            children = node.block_items \
+                if hasattr(node, 'block_items') else [node]
+            rel_lists = []
+            for child in children:
                 index, rel_list, exit_ = Analysis.compute_relation(
-                    index, node, dg)
+                    index, child, store)
                 if exit_:
                     return index, exit_
-                relation_list.composition(rel_list)
+                rel_lists.append(rel_list)
+            relation_list.relations = compose_chain(rel_lists).relations
         return index, False
 
     @staticmethod
-    def while_(index: int, node: While, dg: DeltaGraph) \
+    @timed('while')
+    def while_(index: int, node: While, store: InfinityStore) \
             -> Tuple[int, RelationList, bool]:
         """Analyze while loop.
 
         Arguments:
             index: delta index
             node: while loop node
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
         """
         logger.debug("analysing While")
 
-        relations = RelationList()
+        rel_lists = []
         for child in node.stmt.block_items:
             index, rel_list, exit_ = Analysis.compute_relation(
-                index, child, dg)
+                index, child, store)
             if exit_:
                 return index, rel_list, exit_
-            relations.composition(rel_list)
+            rel_lists.append(rel_list)
+        relations = compose_chain(rel_lists)
 
         logger.debug('while loop fixpoint')
         relations.fixpoint()
-        relations.while_correction(dg)
-
-        dg.fusion()
+        relations.while_correction(store)
 
         exit_ = False
-        if 0 in dg.graph_dict:
-            if dg.graph_dict[0] == {(): {}}:
-                logger.info(f'delta graph:\n{dg}')
-                logger.info('delta_graphs: infinite')
-                logger.info('Exit now !')
-                exit_ = True
+        if store.full:
+            logger.info('infinity store: infinite')
+            logger.info('Exit now !')
+            exit_ = True
 
         return index, relations, exit_
 
     @staticmethod
-    def for_(index: int, node: For, dg: DeltaGraph) \
+    @timed('for')
+    def for_(index: int, node: For, store: InfinityStore) \
             -> Tuple[int, RelationList, bool]:
         """Analyze for loop node.
 
         Arguments:
             index: delta index
             node: for loop node
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
         """
         logger.debug("analysing for:")
 
-        relations = RelationList()
+        rel_lists = []
         for child in node.stmt.block_items:
             index, rel_list, exit_ = Analysis.compute_relation(
-                index, child, dg)
+                index, child, store)
             if exit_:
                 return index, rel_list, True
-            relations.composition(rel_list)
+            rel_lists.append(rel_list)
+        relations = compose_chain(rel_lists)
 
         relations.fixpoint()
         # TODO: unknown method conditionRel
@@ -430,7 +661,7 @@ class Analysis:
         return index, relations, False
 
     @staticmethod
-    def compound_(index: int, node: Compound, dg: DeltaGraph) \
+    def compound_(index: int, node: Compound, store: InfinityStore) \
             -> Tuple[int, RelationList, bool]:
         """Compound AST node contains zero or more children and is
         created by braces in source code.
@@ -440,20 +671,20 @@ class Analysis:
         Arguments:
             index: delta index
             node: compound AST node
-            dg: [DeltaGraph instance](delta_graphs.md#pymwp.delta_graphs)
+            store: [choices leading to infinity](infinity.md)
 
         Returns:
             Updated index value, relation list, and an exit flag.
         """
-        relations = RelationList()
+        rel_lists = []
         if node.block_items:
             for node in node.block_items:
                 index, rel_list, exit_ = Analysis.compute_relation(
-                    index, node, dg)
-                relations.composition(rel_list)
+                    index, node, store)
+                rel_lists.append(rel_list)
                 if exit_:
-                    return index, relations, True
-        return index, relations, False
+                    return index, compose_chain(rel_lists), True
+        return index, compose_chain(rel_lists), False
 
     @staticmethod
     def create_vector(
@@ -484,31 +715,73 @@ class Analysis:
         # x = … (if x not in …), i.e. when left side variable does not
         # occur on the right side of assignment, we prepend 0 to vector
         if x != y and x != z:
-            vector.append(Polynomial('o'))
+            vector.append(backend.polynomial('o'))
 
         if operator in {"+", "-", "*"} and (y is None or z is None):
-            vector.append(Polynomial.from_scalars(index, 'm', 'm', 'm'))
+            vector.append(backend.from_scalars(index, 'm', 'm', 'm'))
 
         elif operator == '*' and y == z:
-            vector.append(Polynomial.from_scalars(index, 'w', 'w', 'w'))
+            vector.append(backend.from_scalars(index, 'w', 'w', 'w'))
 
         elif operator == '*' and y != z:
-            vector.append(Polynomial.from_scalars(index, 'w', 'w', 'w'))
-            vector.append(Polynomial.from_scalars(index, 'w', 'w', 'w'))
+            vector.append(backend.from_scalars(index, 'w', 'w', 'w'))
+            vector.append(backend.from_scalars(index, 'w', 'w', 'w'))
 
         elif operator in {'+', '-'} and y == z:
-            vector.append(Polynomial.from_scalars(index, 'p', 'p', 'w'))
+            vector.append(backend.from_scalars(index, 'p', 'p', 'w'))
 
         elif operator in {'+', '-'} and y != z:
-            vector.append(Polynomial.from_scalars(index, 'm', 'p', 'w'))
-            vector.append(Polynomial.from_scalars(index, 'p', 'm', 'w'))
+            vector.append(backend.from_scalars(index, 'm', 'p', 'w'))
+            vector.append(backend.from_scalars(index, 'p', 'm', 'w'))
 
         return index + 1, vector
 
     @staticmethod
-    def func_call(index: int) \
-            -> Tuple[int, RelationList, bool]:
-        """Function call handler stub."""
-        logger.debug('Function call detected!\nThis feature is not yet '
-                     'supported, but will be added soon')
-        return index, RelationList(), False
+    def func_call(index: int, node: Union[FuncCall, Assignment],
+                  store: InfinityStore) -> Tuple[int, RelationList, bool]:
+        """Analyze function call, `f(...)` or `x = f(...)`.
+
+        A call is analyzed with the [summary](calls.md#pymwp.calls.Summary)
+        of the called function: column `x` gets, for each argument
+        variable, the flow of the parameters it is passed to, with the
+        deltas of the summary relocated after `index`. Choices of the
+        called function that lead to infinity are inserted in `store`,
+        also when its value is not assigned; such calls, and calls
+        without summary, leave variables unchanged.
+
+        Arguments:
+            index: delta index
+            node: function call, or assignment of a function call
+            store: [choices leading to infinity](infinity.md)
+
+        Returns:
+            Updated index value, relation list, and an exit flag.
+        """
+        assigned = isinstance(node, Assignment)
+        call = node.rvalue if assigned else node
+        summary = SummaryTable.find(call)
+        if summary is None:
+            logger.debug('no summary of called function, skipping')
+            return index, RelationList(), False
+        if summary.infinite:
+            logger.info('called function is infinite')
+            return index, RelationList(), True
+        summary.relocate(store, index)
+        args = summary.arguments(call) if assigned else None
+        if args is None:
+            logger.debug('no data flow from call')
+            return index + summary.index, RelationList(), store.full
+
+        logger.debug('Computing Relation x = f(...)')
+        x = node.lvalue.name
+        variables = list(dict.fromkeys([x] + [a for a in args if a]))
+        vector = [backend.zero()] * len(variables)
+        for param, arg in enumerate(args):
+            if arg is not None:
+                position = variables.index(arg)
+                vector[position] = vector[position] + \
+                    summary.flow(param, index)
+
+        rel_list = RelationList.identity(variables)
+        rel_list.replace_column(vector, x)
+        return index + summary.index, rel_list, store.full
@@ -0,0 +1,89 @@
+"""
+Selection of polynomial representation.
+
+The analysis creates polynomials through this module, which builds them
+with the currently selected backend:
+
+- `list`: [`Polynomial`](polynomial.md#pymwp.polynomial.Polynomial),
+  sorted list of monomials (default)
+- `mdd`: [`MDDPolynomial`](mdd.md#pymwp.mdd.MDDPolynomial), decision
+  diagram
+
+Both backends give the same choices and infinity, but differ in how fast
+they compute them. Their matrices are equivalent: each polynomial has the
+same scalar for every assignment of choices, but may be printed in a
+different form, e.g. `mdd` prints `+w` where `list` prints
+`+w.delta(0,0)+w.delta(1,0)+w.delta(2,0)`. Select backend before
+analysis, e.g. with command line argument `--backend mdd`, or:
+
+```python
+backend.use('mdd')
+```
+"""
+
+from typing import Dict, List, Optional, Union
+
+from .mdd import MDDPolynomial
+from .monomial import Monomial
+from .polynomial import Polynomial
+from .semiring import KEYS, ZERO_MWP, UNIT_MWP
+
+BACKENDS = {'list': Polynomial, 'mdd': MDDPolynomial}
+"""Available polynomial backends by name."""
+
+DEFAULT = 'list'
+"""Name of default backend."""
+
+_current = BACKENDS[DEFAULT]
+_constants: Dict[str, object] = {s: _current.of_scalar(s) for s in KEYS}
+
+
+def use(name: str) -> None:
+    """Select polynomial backend.
+
+    Arguments:
+        name: backend name, one of `BACKENDS`
+
+    Raises:
+        ValueError: if backend does not exist.
+    """
+    global _current, _constants
+    if name not in BACKENDS:
+        raise ValueError(f'unknown polynomial backend: {name}')
+    _current = BACKENDS[name]
+    _constants = {s: _current.of_scalar(s) for s in KEYS}
+
+
+def name() -> str:
+    """Get name of selected backend."""
+    return next(k for k, v in BACKENDS.items() if v is _current)
+
+
+def polynomial(monomials: Optional[Union[str, List[Monomial]]] = None):
+    """Create polynomial with selected backend; arguments are the same as
+    for [`Polynomial`](polynomial.md#pymwp.polynomial.Polynomial.__init__).
+    """
+    return _current(monomials)
+
+
+def from_scalars(index: int, *scalars: str):
+    """Create polynomial with selected backend, see
+    [`Polynomial.from_scalars`](polynomial.md#pymwp.polynomial.Polynomial.from_scalars).
+    """  # noqa: E501
+    return _current.from_scalars(index, *scalars)
+
+
+def constant(scalar: str):
+    """Constant polynomial of selected backend; there is one for each
+    scalar, shared by all matrices."""
+    return _constants[scalar]
+
+
+def zero():
+    """Polynomial 0 of selected backend."""
+    return _constants[ZERO_MWP]
+
+
+def unit():
+    """Polynomial m of selected backend."""
+    return _constants[UNIT_MWP]
@@ -0,0 +1,152 @@
+# flake8: noqa: W605
+
+"""
+Relation of straight-line code, kept as independent blocks.
+
+Consecutive statements often involve disjoint variables, e.g. in
+`c_files/other/explosion.c` every assignment has its own three variables.
+Composing such statements into one relation over all variables of the
+function makes each composition as large as the whole function.
+[`BlockRelation`](blocks.md#pymwp.blocks.BlockRelation) instead keeps the
+composition as a block-diagonal collection of small relations over
+disjoint variables, and implicitly identity elsewhere. A statement is
+composed only with the blocks whose variables it involves, and these
+blocks are merged into one. Composition cost then follows the size of the
+connected blocks, not the number of variables.
+
+The result is the same as composition of the full relations: entries
+between two blocks are $0$, and $0$ times a polynomial is $0$ unless the
+polynomial is $\\infty$ for some choice. Once a relation with $\\infty$
+is involved, the blocks are merged into one relation over all variables,
+and composition continues as usual. Every $\\infty$ is recorded in the
+[infinity store](infinity.md) of the analysis when it is introduced, so
+statements are not checked for $\\infty$ while the store is empty.
+"""
+
+from __future__ import annotations
+
+from typing import List, Optional
+
+from . import matrix as matrix_utils
+from .infinity import InfinityStore
+from .mdd import BOT
+from .relation import Relation
+
+
+class BlockRelation:
+    """Relation over all variables of a function, made of relations over
+    disjoint variables that are implicitly identity elsewhere."""
+
+    def __init__(self, variables: List[str],
+                 blocks: Optional[List[Relation]] = None,
+                 infinite: bool = False,
+                 store: Optional[InfinityStore] = None):
+        """Create block relation; without blocks it is an identity
+        relation.
+
+        Arguments:
+            variables: all variables of the relation
+            blocks: relations over disjoint subsets of `variables`
+            infinite: set when some block may have $\\infty$; the
+                relation is then kept as one block
+            store: choices leading to infinity in the analysis that
+                composes this relation
+        """
+        self.variables = variables[:]
+        self.blocks = blocks or []
+        self.infinite = infinite
+        self.store = store
+        self._matrix = None
+
+    @property
+    def matrix(self) -> List[List]:
+        """Matrix of the relation over all of its variables."""
+        if self._matrix is None:
+            self._matrix = self.relation().matrix
+        return self._matrix
+
+    @property
+    def is_empty(self):
+        return not self.variables
+
+    def __str__(self):
+        return str(self.relation())
+
+    def __mul__(self, other):
+        return self.composition(other)
+
+    def relation(self) -> Relation:
+        """Assemble the blocks into one relation over all variables."""
+        if len(self.blocks) == 1 and \
+                self.blocks[0].variables == self.variables:
+            return self.blocks[0]
+        position = {v: i for i, v in enumerate(self.variables)}
+        matrix = matrix_utils.identity_matrix(len(self.variables))
+        for block in self.blocks:
+            index = [position[v] for v in block.variables]
+            for a, i in enumerate(index):
+                for b, j in enumerate(index):
+                    matrix[i][j] = block.matrix[a][b]
+        return Relation(self.variables, matrix)
+
+    def equal(self, other: BlockRelation) -> bool:
+        """Determine if two block relations are equal.
+
+        Blocks over the same variables are compared one by one. Where
+        the blocks of the two relations cover different variables, only
+        the variables of their blocks are compared, since both are
+        identity elsewhere.
+
+        Arguments:
+            other: block relation to compare
+
+        Returns:
+            True when the two relations are equal.
+        """
+        if set(self.variables) != set(other.variables):
+            return False
+        mine = {frozenset(b.variables): b for b in self.blocks}
+        theirs = {frozenset(b.variables): b for b in other.blocks}
+        if mine.keys() == theirs.keys():
+            return all(mine[key].equal(theirs[key]) for key in mine)
+        covered = list(dict.fromkeys(
+            v for block in self.blocks + other.blocks
+            for v in block.variables))
+        return BlockRelation(covered, self.blocks).relation().equal(
+            BlockRelation(covered, other.blocks).relation())
+
+    def composition(self, other: Relation) -> BlockRelation:
+        """Compose with the relation of a statement.
+
+        Blocks that share variables with `other` are merged and composed
+        with it; other blocks are kept as they are.
+
+        Arguments:
+            other: relation to compose with `self`
+
+        Returns:
+            Block relation of the composition.
+        """
+        known = set(self.variables)
+        variables = self.variables + [
+            v for v in other.variables if v not in known]
+        if self.infinite or (
+                (self.store is None or self.store.node != BOT)
+                and other.infinity != BOT):
+            # infinity flows into entries outside of the blocks
+            return BlockRelation(
+                variables, [self.relation() * other], True, self.store)
+        touched = set(other.variables)
+        if not touched:
+            return BlockRelation(variables, self.blocks, store=self.store)
+        kept, connected = [], []
+        for block in self.blocks:
+            if touched.isdisjoint(block.variables):
+                kept.append(block)
+            else:
+                connected.append(block)
+        merged = BlockRelation(
+            [v for block in connected for v in block.variables],
+            connected).relation()
+        return BlockRelation(
+            variables, kept + [merged * other], store=self.store)
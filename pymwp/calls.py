@@ -0,0 +1,313 @@
+"""
+Function calls between functions of one translation unit.
+
+[`CallGraph`](calls.md#pymwp.calls.CallGraph) records which defined
+functions each function calls, and groups them into strongly connected
+components, i.e. sets of mutually recursive functions. The analysis
+visits components bottom-up, callees before callers, and keeps for each
+analyzed function a [`Summary`](calls.md#pymwp.calls.Summary): how the
+value it returns depends on its parameters, and which of its choices lead
+to $\\infty$. A call `x = f(y, z)` is then analyzed by instantiating the
+summary of `f`, rather than by analysing `f` again:
+
+- parameters are mapped to the arguments, which are variables or
+  constants, and the column of `x` gets, for each argument variable, the
+  sum of the flows of the parameters it is passed to;
+- the deltas of the summary are relocated after the current delta index,
+  so each call site gets its own choices;
+- choices of the callee that lead to $\\infty$ are inserted, relocated in
+  the same way, in the [store](infinity.md) of the caller.
+
+Calls inside a component, and calls to functions that are not defined in
+the translation unit, have no summary, and the call is skipped. Calls
+whose value is not assigned, or whose arguments or returned values are
+other expressions, have no data flow; the choices of the callee that
+lead to $\\infty$ are still inserted, and calling an infinite function
+is infinite.
+
+Components that do not depend on each other are on the same
+[`level`](calls.md#pymwp.calls.CallGraph.levels); with more than one
+[job](workers.md), components of a level are analyzed in worker
+processes.
+"""
+
+from __future__ import annotations
+
+from array import array
+from typing import Dict, List, Optional, Tuple
+
+from pycparser import c_ast
+from pycparser.c_ast import FuncCall, FuncDef
+
+from . import backend
+from .infinity import InfinityStore, SEQ
+from .mdd import MANAGER, SUM_TABLE
+from .parallel import PACKED, pack, unpack
+from .relation import Relation
+from .relation_list import RelationList
+from .workers import pack_polynomial, unpack_polynomial
+
+
+class _Visitor(c_ast.NodeVisitor):
+    """Collect calls and returned expressions of a function body."""
+
+    def __init__(self):
+        self.calls: List[str] = []
+        self.returns: List[c_ast.Node] = []
+
+    def visit_FuncCall(self, node: FuncCall) -> None:
+        if isinstance(node.name, c_ast.ID):
+            self.calls.append(node.name.name)
+        self.generic_visit(node)
+
+    def visit_Return(self, node: c_ast.Return) -> None:
+        if node.expr is not None:
+            self.returns.append(node.expr)
+
+
+def _visit(function: FuncDef) -> _Visitor:
+    visitor = _Visitor()
+    visitor.visit(function.body)
+    return visitor
+
+
+def parameters(function: FuncDef) -> List[str]:
+    """Names of the parameters of a function definition."""
+    args = function.decl.type.args
+    if not args or not args.params:
+        return []
+    return [p.name for p in args.params
+            if isinstance(p, c_ast.Decl) and p.name]
+
+
+class CallGraph:
+    """Calls between the functions of one translation unit."""
+
+    def __init__(self, functions: List[FuncDef]):
+        """Create call graph.
+
+        Arguments:
+            functions: function definitions, in file order
+        """
+        self.functions: Dict[str, FuncDef] = {
+            f.decl.name: f for f in functions}
+        self.callees: Dict[str, List[str]] = {
+            name: [c for c in dict.fromkeys(_visit(f).calls)
+                   if c in self.functions]
+            for name, f in self.functions.items()}
+
+    def components(self) -> List[List[str]]:
+        """Strongly connected components, callees before callers.
+
+        Returns:
+            Function names of each component, in file order.
+        """
+        order = {name: n for n, name in enumerate(self.functions)}
+        index: Dict[str, int] = {}
+        low: Dict[str, int] = {}
+        stack, on_stack, result = [], set(), []
+        for root in self.functions:
+            if root in index:
+                continue
+            # iterative Tarjan: frames of (function, next callee position)
+            frames = [(root, 0)]
+            index[root] = low[root] = len(index)
+            stack.append(root)
+            on_stack.add(root)
+            while frames:
+                name, position = frames.pop()
+                callees = self.callees[name]
+                if position < len(callees):
+                    frames.append((name, position + 1))
+                    callee = callees[position]
+                    if callee not in index:
+                        index[callee] = low[callee] = len(index)
+                        stack.append(callee)
+                        on_stack.add(callee)
+                        frames.append((callee, 0))
+                    elif callee in on_stack:
+                        low[name] = min(low[name], index[callee])
+                    continue
+                if frames:
+                    caller = frames[-1][0]
+                    low[caller] = min(low[caller], low[name])
+                if low[name] == index[name]:
+                    component = []
+                    while True:
+                        member = stack.pop()
+                        on_stack.discard(member)
+                        component.append(member)
+                        if member == name:
+                            break
+                    result.append(sorted(component, key=order.get))
+        return result
+
+    def levels(self) -> List[List[List[str]]]:
+        """Components grouped by depth in the call graph.
+
+        Components of level 0 call no other component; components of a
+        later level only call components of earlier levels, so the
+        components of one level can be analyzed independently.
+        """
+        level: Dict[str, int] = {}
+        result: List[List[List[str]]] = []
+        for component in self.components():
+            members = set(component)
+            depth = max((level[c] + 1 for name in component
+                         for c in self.callees[name] if c not in members),
+                        default=0)
+            for name in component:
+                level[name] = depth
+            if depth == len(result):
+                result.append([])
+            result[depth].append(component)
+        return result
+
+
+class Summary:
+    """Result of the analysis of a function, as seen by its callers."""
+
+    def __init__(self, params: List[str], index: int,
+                 flows: Optional[List[bytes]], cubes: Tuple[SEQ, ...],
+                 infinite: bool):
+        """Create summary.
+
+        Arguments:
+            params: parameter names, in order
+            index: number of deltas of the function
+            flows: for each parameter, packed polynomial of the flow from
+                that parameter to the returned value; `None` when returned
+                values are not variables or constants
+            cubes: delta sequences that lead to $\\infty$
+            infinite: the function has no polynomial bound
+        """
+        self.params = params
+        self.index = index
+        self.flows = flows
+        self.cubes = cubes
+        self.infinite = infinite
+
+    @staticmethod
+    def of(function: FuncDef, relation: Optional[Relation], index: int,
+           store: InfinityStore, infinite: bool) -> Summary:
+        """Summarize the analysis of a function.
+
+        Arguments:
+            function: function definition
+            relation: final relation of the function, unless infinite
+            index: number of deltas of the function
+            store: choices of the function that lead to $\\infty$
+            infinite: the function has no polynomial bound
+
+        Returns:
+            Summary of the function.
+        """
+        params = parameters(function)
+        if infinite or relation is None:
+            return Summary(params, index, None, (), True)
+        returns = _visit(function).returns
+        names = list(dict.fromkeys(
+            r.name for r in returns if isinstance(r, c_ast.ID)))
+        flows = None
+        if all(isinstance(r, (c_ast.ID, c_ast.Constant)) for r in returns) \
+                and set(names) <= set(relation.variables):
+            flows = []
+            matrix, variables = relation.matrix, relation.variables
+            for param in params:
+                flow = backend.zero()
+                if param in variables:
+                    row = matrix[variables.index(param)]
+                    for name in names:
+                        flow = flow + row[variables.index(name)]
+                values = array('I')
+                pack_polynomial(flow, values)
+                flows.append(values.tobytes())
+        region = MANAGER.apply(SUM_TABLE, store.node, relation.infinity)
+        return Summary(params, index, flows, MANAGER.cover(region), False)
+
+    def arguments(self, call: FuncCall) -> Optional[List[Optional[str]]]:
+        """Map parameters to arguments of a call.
+
+        Arguments:
+            call: function call node
+
+        Returns:
+            Variable passed to each parameter, `None` for a constant; or
+            `None` if the call cannot be applied with this summary.
+        """
+        exprs = call.args.exprs if call.args else []
+        if self.flows is None or len(exprs) != len(self.params):
+            return None
+        result = []
+        for expr in exprs:
+            if isinstance(expr, c_ast.ID):
+                result.append(expr.name)
+            elif isinstance(expr, c_ast.Constant):
+                result.append(None)
+            else:
+                return None
+        return result
+
+    def flow(self, param: int, offset: int):
+        """Flow from a parameter to the returned value, with deltas moved
+        by `offset`, as a polynomial of the selected backend."""
+        values = array('I', self.flows[param])
+        return unpack_polynomial(values, 0, len(values), offset)
+
+    def relocate(self, store: InfinityStore, offset: int) -> None:
+        """Insert choices that lead to $\\infty$ in the store of a caller,
+        with deltas moved by `offset`."""
+        for cube in self.cubes:
+            store.insert(tuple((c, i + offset) for c, i in cube))
+
+
+class SummaryTable(dict):
+    """Summaries of analyzed functions, by name.
+
+    Like [`VariableTable`](variables.md#pymwp.variables.VariableTable),
+    the table is made current with a `with` statement, and calls analyzed
+    meanwhile use its summaries.
+    """
+
+    current: Optional[SummaryTable] = None
+    """Table that calls use; `None` when no table is active."""
+
+    previous: Optional[SummaryTable] = None
+
+    @staticmethod
+    def find(call: FuncCall) -> Optional[Summary]:
+        """Summary of the function called by `call` in the current table,
+        if any."""
+        table = SummaryTable.current
+        if table is None or not isinstance(call.name, c_ast.ID):
+            return None
+        return table.get(call.name.name)
+
+    def __enter__(self) -> SummaryTable:
+        """Make calls use this table."""
+        self.previous = SummaryTable.current
+        SummaryTable.current = self
+        return self
+
+    def __exit__(self, *_) -> None:
+        SummaryTable.current = self.previous
+        self.previous = None
+
+
+def pack_result(result: Tuple) -> Tuple:
+    """Encode analysis result of a function to send it between processes;
+    the relation is encoded with [`pack`](parallel.md#pymwp.parallel.pack).
+    """
+    relation, choices, infinite = result
+    if relation is not None:
+        relation = pack(RelationList(relation_list=[relation]))
+    return relation, choices, infinite
+
+
+def unpack_result(result: Tuple[Optional[PACKED], object, bool]) -> Tuple:
+    """Decode analysis result encoded by
+    [`pack_result`](calls.md#pymwp.calls.pack_result)."""
+    relation, choices, infinite = result
+    if relation is not None:
+        relation = unpack(relation).first
+    return relation, choices, infinite
@@ -4,6 +4,8 @@ import logging
 from functools import reduce
 from typing import Tuple, List, Set, Union
 
+from . import native
+
 logger = logging.getLogger(__name__)
 
 SEQ = Set[Tuple[Tuple[int, int], ...]]
@@ -78,6 +80,10 @@ class Choices:
            # Read as: choose one of vectors (1st, 2nd) then at each index
            # choose one of the remaining choices, to get a valid derivation.
            ```
+
+    The analysis obtains its vectors from a
+    [`ChoiceDiagram`](mdd.md#pymwp.mdd.ChoiceDiagram) instead, which
+    computes the same valid choices symbolically, as disjoint vectors.
     """
 
     def __init__(self, vectors: CHOICES = None):
@@ -115,10 +121,12 @@ class Choices:
         # reduce when all paths exist and lead to same infinity choice
         Choices.reduce_subsequences(choices, sequences)
 
-        # now only min unique paths that lead to infinity remain
-        paths = [str(list(i)) for i in sorted(
-            list(sequences), key=lambda x: (len(x), x))]
-        logger.debug(f'infinity paths: {" # ".join(paths) or "None"}')
+        # now only min unique paths that lead to infinity remain;
+        # formatting them is costly so only do it when it will be logged
+        if logger.isEnabledFor(logging.DEBUG):
+            paths = [str(list(i)) for i in sorted(
+                list(sequences), key=lambda x: (len(x), x))]
+            logger.debug('infinity paths: %s', " # ".join(paths) or "None")
 
         # build vectors representing valid choices
         valid = Choices.build_choices(choices, index, sequences)
@@ -160,6 +168,9 @@ class Choices:
             Reduced list where all longer patterns, whose pattern is covered
             by some shorter sequence, are removed.
         """
+        kernel = native.choice_kernel()
+        if kernel is not None:
+            return set(kernel.unique_sequences(infinities))
         sequences = set()
         infinity_deltas: List[SEQ] = sorted(list(infinities), key=len)
         while infinity_deltas:
@@ -191,6 +202,10 @@ class Choices:
             choices: list of valid per index choices, e.g. [0,1,2]
             sequences: set of delta sequences
         """
+        kernel = native.choice_kernel()
+        if kernel is not None:
+            kernel.reduce_subsequences(choices, sequences)
+            return
         while Choices.reduce(choices, sequences):
             pass
 
@@ -303,7 +318,13 @@ class Choices:
 
         # the product of path lengths gives the max number of distinct vectors
         max_ = Choices.prod(lens)
-        logger.debug(f'maximum distinct vectors: {max_}')
+        logger.debug('maximum distinct vectors: %d', max_)
+
+        # the native kernel builds the same vectors in the same order
+        kernel = native.choice_kernel()
+        found = kernel and kernel.build_choices(choices, index, sorted_infty)
+        if found is not None:
+            return [list([list(c) for c in v]) for v in set(found)]
 
         vectors = set()
 
@@ -0,0 +1,186 @@
+"""
+Deterministic counts of kernel operations.
+
+Wall time of the analysis varies with machine load, but the number of
+operations it performs does not. [`Counters`](counters.md#pymwp.counters.Counters)
+records how many times the algebra kernels run, so that changes in the
+amount of work can be detected exactly.
+
+Counters are opt-in: while no counter is active, the kernels are the
+original, unwrapped functions and counting costs nothing. Starting a
+counter wraps the kernels, and stopping it restores them.
+
+Recorded counts:
+
+| name                  | meaning                                        |
+| --------------------- | ---------------------------------------------- |
+| `prod_mwp`            | calls of scalar product                        |
+| `sum_mwp`             | calls of scalar sum                            |
+| `monomials`           | monomials created                              |
+| `times`               | calls of `Polynomial.times`                    |
+| `times_terms`         | sum of products of input monomial counts       |
+| `add`                 | calls of `Polynomial.add`                      |
+| `add_terms`           | sum of input monomial counts                   |
+| `matrix_prod`         | calls of matrix product, also of scalars       |
+| `matrix_prod_cells`   | cells computed by matrix product               |
+| `fixpoint_iterations` | iterations of relation fixpoint or closure     |
+| `correction_cells`    | matrix entries checked by while correction     |
+| `infinity_inserts`    | sequences inserted in an infinity store        |
+| `choice_terms`        | infinite terms combined into choice diagrams   |
+
+Example:
+
+```python
+with Counters() as counters:
+    Analysis.run(ast, no_save=True)
+print(counters.counts['prod_mwp'])
+```
+"""  # noqa: E501
+
+import sys
+from functools import wraps
+from typing import Callable, Dict, List, Optional, Tuple
+
+from . import matrix, mdd, native, semiring
+from .infinity import InfinityStore
+from .mdd import BOT, MDDPolynomial
+from .monomial import Monomial
+from .polynomial import Polynomial
+from .scalars import ScalarMatrix
+from .stats import Collector
+
+NAMES = ['prod_mwp', 'sum_mwp', 'monomials', 'times', 'times_terms', 'add',
+         'add_terms', 'matrix_prod', 'matrix_prod_cells',
+         'fixpoint_iterations', 'correction_cells', 'infinity_inserts',
+         'choice_terms']
+"""Names of recorded counts."""
+
+
+class Counters(Collector):
+    """Counts kernel operations while active.
+
+    Only one counter can be active at a time.
+    """
+
+    active_counter: Optional['Counters'] = None
+
+    def __init__(self):
+        self.counts: Dict[str, int] = dict.fromkeys(NAMES, 0)
+        self.restore: List[Tuple[object, str, object]] = []
+
+    def count(self, name: str, amount: int = 1) -> None:
+        self.counts[name] += amount
+
+    def begin(self, name: str, args: dict) -> None:
+        if name == 'fixpoint_iteration':
+            self.count('fixpoint_iterations')
+
+    def start(self) -> None:
+        """Start counting.
+
+        Raises:
+            RuntimeError: if another counter is already active.
+        """
+        if self.active:
+            return
+        if Counters.active_counter is not None:
+            raise RuntimeError('another counter is already active')
+        Counters.active_counter = self
+        super().start()
+        # operations are counted in the Python kernels
+        self.restore.append((native, '_enabled', native.kernel() is not None))
+        native.use(False)
+        for owner, attr, wrapper in self.wrappers():
+            self.patch(owner, attr, wrapper)
+
+    def stop(self) -> None:
+        """Stop counting and restore original kernels."""
+        if not self.active:
+            return
+        super().stop()
+        for owner, attr, original in reversed(self.restore):
+            setattr(owner, attr, original)
+        self.restore = []
+        Counters.active_counter = None
+
+    def patch(self, owner: object, attr: str, wrapper: Callable) -> None:
+        """Replace `owner.attr` with wrapper of it.
+
+        Module-level functions are also replaced in every pymwp module
+        that imported them by name.
+        """
+        original = owner.__dict__[attr]
+        if isinstance(owner, type):
+            targets = [owner]
+        else:
+            targets = [module for name, module in list(sys.modules.items())
+                       if name.startswith('pymwp') and module is not None
+                       and getattr(module, attr, None) is original]
+        for target in targets:
+            self.restore.append((target, attr, original))
+            setattr(target, attr, wrapper(original))
+
+    def wrappers(self) -> List[Tuple[object, str, Callable]]:
+        """List of kernels to wrap, and how to count their calls."""
+        count = self.count
+
+        def calls(name, size=None):
+            def wrapper(func):
+                @wraps(func)
+                def counted(*args, **kwargs):
+                    if name:
+                        count(name)
+                    if size:
+                        size(*args)
+                    return func(*args, **kwargs)
+
+                return counted
+
+            return wrapper
+
+        def times_terms(p1, p2):
+            count('times_terms', len(p1.list) * len(p2.list))
+
+        def add_terms(p1, p2):
+            count('add_terms', len(p1.list) + len(p2.list))
+
+        def cells(m1, m2):
+            count('matrix_prod_cells', len(m1) * len(m2))
+
+        def extended_cells(_m1, index1, _m2, _index2):
+            count('matrix_prod_cells', len(index1) * len(index1))
+
+        def scalar_cells(m1, _m2):
+            count('matrix_prod_cells', m1.size * m1.size)
+
+        def corrected_cells(m1):
+            count('correction_cells', m1.size * m1.size)
+
+        def choice_terms(func):
+            # polynomials are counted as the diagram consumes them
+            def counted(polynomials, node=BOT):
+                def terms():
+                    for poly in polynomials:
+                        count('choice_terms', 1 if isinstance(
+                            poly, MDDPolynomial) else len(poly.eval))
+                        yield poly
+
+                return func(terms(), node)
+
+            return wraps(func)(counted)
+
+        return [
+            (semiring, 'prod_mwp', calls('prod_mwp')),
+            (semiring, 'sum_mwp', calls('sum_mwp')),
+            (Monomial, '__init__', calls('monomials')),
+            (Polynomial, 'times', calls('times', times_terms)),
+            (Polynomial, 'add', calls('add', add_terms)),
+            (matrix, 'matrix_prod', calls('matrix_prod', cells)),
+            (matrix, 'extended_prod',
+             calls('matrix_prod', extended_cells)),
+            (ScalarMatrix, 'prod', calls('matrix_prod', scalar_cells)),
+            (ScalarMatrix, 'while_correction', calls(None, corrected_cells)),
+            (Polynomial, 'while_correction',
+             calls('correction_cells')),
+            (InfinityStore, 'insert', calls('infinity_inserts')),
+            (mdd, 'infinity_of', choice_terms)]
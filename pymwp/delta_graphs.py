@@ -50,6 +50,10 @@ class DeltaGraph:
 
     This representation will help us simplify the evaluation by
     removing redundant/irrelevant choices/paths.
+
+    The analysis records infinite choices in an
+    [`InfinityStore`](infinity.md#pymwp.infinity.InfinityStore), which
+    performs the same fusion on a decision diagram.
     """
 
     def __init__(self, monomials: Optional[List[Monomial]] = None):
@@ -290,8 +294,7 @@ class DeltaGraph:
         Returns:
             list of indices.
         """
-        _, listi = zip(*lm)
-        return listi
+        return tuple(i for _, i in lm)
 
     # def fusion(self, list_of_max, max_i=None):
     def fusion(self, max_i: Optional[int] = 3) -> None:
@@ -3,32 +3,35 @@ import sys
 import json
 import logging
 
-from typing import Tuple, Dict, Optional
+from typing import Tuple, Dict, Optional, Iterator, TextIO
 from pycparser import parse_file, c_ast
 from subprocess import CalledProcessError
 
 from .choice import Choices
 from .relation import Relation
 from .matrix import decode
+from .stats import timed
 
 logger = logging.getLogger(__name__)
 RESULT_TYPE = Tuple[Optional[Relation], Optional[Choices], bool]
 
 
-def default_file_out(input_file: str) -> str:
+def default_file_out(input_file: str, extension: str = "json") -> str:
     """Generates default output file.
 
     Arguments:
         input_file: input filename (with or without path)
+        extension: file extension of the output file
 
     Returns:
         Generated output filename with path.
     """
     file_only = os.path.splitext(input_file)[0]
     file_name = os.path.basename(file_only)
-    return os.path.join("output", f"{file_name}.json")
+    return os.path.join("output", f"{file_name}.{extension}")
 
 
+@timed('save_relation')
 def save_relation(
         file_name: str, analysis_result: Dict[str, RESULT_TYPE]
 ) -> None:
@@ -52,27 +55,17 @@ def save_relation(
                 - `[2]`: `True` when function does not have polynomial bounds
     """
 
-    file_content = {}
-
-    for function_name, result in analysis_result.items():
-        relation, choices, infinity = result
-
-        file_content[function_name] = {
-            "relation": relation.to_dict() if relation else None,
-            "choices": choices.valid if choices else None,
-            "infinity": infinity
-        }
+    file_content = {function_name: encode_result(result)
+                    for function_name, result in analysis_result.items()}
 
     # ensure directory path exists
-    dir_path, _ = os.path.split(file_name)
-    if len(dir_path) > 0 and not os.path.exists(dir_path):
-        os.makedirs(dir_path)
+    ensure_dir(file_name)
 
     # write to file
     with open(file_name, "w") as outfile:
         json.dump(file_content, outfile, indent=4)
 
-    logger.info(f'saved result in {file_name}')
+    logger.info('saved result in %s', file_name)
 
 
 def load_relation(file_name: str) -> Dict[str, RESULT_TYPE]:
@@ -102,25 +95,128 @@ def load_relation(file_name: str) -> Dict[str, RESULT_TYPE]:
     with open(file_name) as file_object:
         data = json.load(file_object)
 
-    result = {}
+    return {function_name: decode_result(value)
+            for function_name, value in data.items()}
+
+
+def open_stream(file_name: str) -> TextIO:
+    """Open a file for streaming analysis results, one function at a time.
+
+    The stream is newline-delimited JSON: every call to
+    [`write_relation`](file_io.md#pymwp.file_io.write_relation) appends
+    exactly one line. If path to output file does not exist it will be
+    created and an existing file will be overwritten. Caller is responsible
+    for closing the returned stream.
+
+    Arguments:
+        file_name: filename where to write
+
+    Returns:
+        Writable text stream.
+    """
+    ensure_dir(file_name)
+    return open(file_name, "w")
+
+
+@timed('save_relation')
+def write_relation(
+        stream: TextIO, function_name: str, result: RESULT_TYPE
+) -> None:
+    """Write analysis result of one function as a single JSON line.
+
+    The stream is flushed after writing, so that the line is visible to
+    readers as soon as the function has been analyzed.
+
+    Arguments:
+        stream: output stream, see
+            [`open_stream`](file_io.md#pymwp.file_io.open_stream)
+        function_name: name of analyzed function
+        result: analysis result triple of that function
+    """
+    line = {"function": function_name, **encode_result(result)}
+    stream.write(json.dumps(line) + "\n")
+    stream.flush()
+    logger.info('streamed result of %s', function_name)
+
+
+def iterate_relations(file_name: str) -> Iterator[Tuple[str, RESULT_TYPE]]:
+    """Lazily load analysis results from a newline-delimited JSON file.
+
+    This method is the streaming counterpart of
+    [`load_relation`](file_io.md#pymwp.file_io.load_relation) and reads
+    files written by
+    [`write_relation`](file_io.md#pymwp.file_io.write_relation).
+    Lines are read and decoded one at a time, so only one function result
+    is held in memory at once. Blank lines are skipped.
+
+    Arguments:
+        file_name: file to read
+
+    Raises:
+          Exception: if `file_name` does not exist or cannot be read.
+
+    Yields:
+        Pairs of function name and result triple (see `load_relation`).
+    """
+    with open(file_name) as file_object:
+        for line in file_object:
+            if line.strip():
+                value = json.loads(line)
+                yield value["function"], decode_result(value)
+
+
+def encode_result(result: RESULT_TYPE) -> dict:
+    """Get dictionary representation of one function analysis result.
+
+    Arguments:
+        result: triple of relation, choices and infinity flag
+
+    Returns:
+        Dictionary with keys `relation`, `choices` and `infinity`.
+    """
+    relation, choices, infinity = result
+    return {
+        "relation": relation.to_dict() if relation else None,
+        "choices": choices.valid if choices else None,
+        "infinity": infinity
+    }
+
+
+def decode_result(value: dict) -> RESULT_TYPE:
+    """Restore one function analysis result from its dictionary
+    representation; reverse of
+    [`encode_result`](file_io.md#pymwp.file_io.encode_result).
+
+    Arguments:
+        value: encoded result
+
+    Returns:
+        Triple of relation, choices and infinity flag.
+    """
+    relation = None
+    # parse its data
+    if value["relation"]:
+        matrix = value["relation"]["matrix"]
+        variables = value["relation"]["variables"]
+        relation = Relation(variables, decode(matrix))
+    combinations = Choices(value["choices"]) \
+        if "choices" in value else None
+    infinity = value["infinity"]
+    return relation, combinations, infinity
 
-    for function_name, value in data.items():
-        relation = None
-        # parse its data
-        if value["relation"]:
-            matrix = value["relation"]["matrix"]
-            variables = value["relation"]["variables"]
-            relation = Relation(variables, decode(matrix))
-        combinations = Choices(value["choices"]) \
-            if "choices" in value else None
-        infinity = value["infinity"]
 
-        # generate objects
-        result[function_name] = relation, combinations, infinity
+def ensure_dir(file_name: str) -> None:
+    """Create the directory path of a file, if it does not exist.
 
-    return result
+    Arguments:
+        file_name: file path
+    """
+    dir_path, _ = os.path.split(file_name)
+    if len(dir_path) > 0 and not os.path.exists(dir_path):
+        os.makedirs(dir_path)
 
 
+@timed('parse')
 def parse(
         file: str, use_cpp: bool = True, cpp_path: str = 'cpp',
         cpp_args: str = '-E'
@@ -152,15 +248,25 @@ def parse(
     try:
         ast = parse_file(file, use_cpp, cpp_path, cpp_args)
 
-        invalid = ast is None or ast.ext is None or \
-                  len(ast.ext) == 0 or \
-                  ast.ext[0].body is None or \
-                  ast.ext[0].body.block_items is None  # noqa: E127
-
-        if not invalid:
+        if is_analyzable(ast):
             return ast
 
         sys.exit('FATAL: Input C file is invalid or empty. Terminating.')
 
     except CalledProcessError:
         sys.exit('FATAL: Failed to parse C file. Terminating.')
+
+
+def is_analyzable(ast: c_ast) -> bool:
+    """Check that a parsed AST has some meaningful content to analyze.
+
+    Arguments:
+        ast: parsed C source code AST
+
+    Returns:
+        True if AST contains at least one function with a non-empty body.
+    """
+    return not (ast is None or ast.ext is None or
+                len(ast.ext) == 0 or
+                getattr(ast.ext[0], 'body', None) is None or
+                ast.ext[0].body.block_items is None)
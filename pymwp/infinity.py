@@ -0,0 +1,66 @@
+# flake8: noqa: W605
+
+"""
+Choices that lead to $\\infty$, collected during analysis.
+
+While correction of every loop inserts the delta sequences that became
+$\\infty$ into one store per function. The store keeps their union as a
+decision diagram, in the [`MDD manager`](mdd.md#pymwp.mdd.Manager) shared
+by all diagrams, so inserted sequences are fused as soon as they are
+inserted: when all choices at some index lead to $\\infty$, the index
+drops out. This is the reduction that
+[`DeltaGraph.fusion`](delta_graphs.md#pymwp.delta_graphs.DeltaGraph.fusion)
+and [`Choices.reduce`](choice.md#pymwp.choice.Choices.reduce) compute
+separately.
+
+The analysis reads the store twice: after each loop, to exit early when
+every choice leads to $\\infty$, and in the final evaluation, which starts
+from the stored region instead of reducing the same sequences again.
+"""
+
+from typing import Iterable, Tuple
+
+from .mdd import MANAGER, BOT, I, SUM_TABLE
+from .stats import timed
+
+SEQ = Tuple[Tuple[int, int], ...]
+"""Type hint to represent a sequence of deltas"""
+
+
+class InfinityStore:
+    """Union of delta sequences that lead to $\\infty$."""
+
+    def __init__(self, sequences: Iterable[SEQ] = ()):
+        """Create store.
+
+        Arguments:
+            sequences: initial delta sequences
+        """
+        self.node = BOT
+        for deltas in sequences:
+            self.insert(deltas)
+
+    @timed('fusion')
+    def insert(self, deltas: SEQ) -> None:
+        """Insert sequence of deltas that leads to $\\infty$; this is
+        where sequences are fused.
+
+        Arguments:
+            deltas: sequence of (choice, index) pairs, ordered by index
+        """
+        self.node = MANAGER.apply(
+            SUM_TABLE, self.node, MANAGER.monomial('i', deltas))
+
+    @property
+    def full(self) -> bool:
+        """True if every choice leads to $\\infty$."""
+        return self.node == I
+
+    @property
+    def cubes(self) -> Tuple[SEQ, ...]:
+        """Fused delta sequences that cover the stored region."""
+        return MANAGER.cover(self.node)
+
+    def __str__(self):
+        return '\n'.join(str(list(c)) for c in sorted(
+            self.cubes, key=lambda c: (len(c), c))) or 'None'
@@ -5,13 +5,17 @@ import logging
 from typing import Any, Optional, List
 from functools import reduce
 
+from . import backend, native, workers
 from .polynomial import Polynomial
 from .monomial import Monomial
 from .semiring import ZERO_MWP, UNIT_MWP
 
-ZERO = Polynomial([Monomial(ZERO_MWP)])
+ZERO = Polynomial.of_scalar(ZERO_MWP)
+"""0-polynomial of list backend; matrices are built with the polynomials
+of the selected [backend](backend.md)."""
 
-UNIT = Polynomial([Monomial(UNIT_MWP)])
+UNIT = Polynomial.of_scalar(UNIT_MWP)
+"""m-polynomial of list backend."""
 
 logger = logging.getLogger(__name__)
 
@@ -43,7 +47,7 @@ def init_matrix(size: int, init_value: Optional[Any] = None) -> List[list]:
     Returns:
         Initialized matrix.
     """
-    value = init_value if init_value is not None else ZERO
+    value = init_value if init_value is not None else backend.zero()
     return [[value for _ in range(size)] for _ in range(size)]
 
 
@@ -72,7 +76,8 @@ def identity_matrix(size: int) -> List[list]:
     Returns:
         New identity matrix.
     """
-    return [[UNIT if i == j else ZERO
+    zero, unit = backend.zero(), backend.unit()
+    return [[unit if i == j else zero
              for j in range(size)] for i in range(size)]
 
 
@@ -117,7 +122,7 @@ def decode(matrix: List[List[List[dict]]]) -> List[List[Polynomial]]:
         Decoded matrix of polynomials.
     """
     return [[
-        Polynomial([Monomial(
+        backend.polynomial([Monomial(
             scalar=monomial["scalar"],
             deltas=monomial["deltas"])
             for monomial in polynomial])
@@ -155,15 +160,169 @@ def matrix_prod(
     Returns:
         new matrix that represents the product of the two inputs.
     """
+    if workers.worthwhile(len(matrix1)):
+        return workers.map_rows(
+            prod_rows, [matrix1, matrix2], len(matrix1))
+    return prod_rows(matrix1, matrix2, range(len(matrix1)))
 
+
+def prod_rows(
+        matrix1: List[List[Polynomial]], matrix2: List[List[Polynomial]],
+        rows: range
+) -> List[List[Polynomial]]:
+    """Compute some rows of the product of two polynomial matrices.
+
+    Arguments:
+        matrix1: first polynomial matrix.
+        matrix2: second polynomial matrix.
+        rows: rows of the product to compute
+
+    Returns:
+        listed rows of the product of the two inputs.
+    """
+    zero = backend.zero()
+    kernel = native.kernel()
+    if kernel is not None and backend.name() == 'list':
+        return kernel.prod_rows(matrix1, matrix2, rows, zero)
     return [[
 
         reduce(lambda total, k:
                total + (matrix1[i][k] * matrix2[k][j]),
-               range(len(matrix1)), ZERO)
+               range(len(matrix1)), zero)
 
         for j in range(len(matrix2))]
-        for i in range(len(matrix1))]
+        for i in rows]
+
+
+def extend(matrix: List[List[Any]], index: List[int]) \
+        -> List[List[Optional[Any]]]:
+    """View matrix over a larger set of variables, without creating
+    polynomials for the added entries.
+
+    Arguments:
+        matrix: original matrix
+        index: row and column of `matrix` at each position of the larger
+            matrix, or -1 where the larger matrix is implicitly identity
+
+    Returns:
+        Matrix of size `len(index)` with `None` at implicit entries.
+    """
+    return [[matrix[i][j] if i >= 0 and j >= 0 else None for j in index]
+            if i >= 0 else [None] * len(index) for i in index]
+
+
+def extended_sum(
+        matrix1: List[List[Polynomial]], index1: List[int],
+        matrix2: List[List[Polynomial]], index2: List[int]
+) -> List[List[Polynomial]]:
+    """Compute the sum of two matrices that are implicitly identity
+    outside of their variables.
+
+    Arguments:
+        matrix1: first polynomial matrix.
+        index1: position of each row of the result in `matrix1`, see
+            [`extend`](matrix.md#pymwp.matrix.extend)
+        matrix2: second polynomial matrix.
+        index2: position of each row of the result in `matrix2`
+
+    Returns:
+        new matrix of size `len(index1)`, equal to the sum of the two
+            inputs resized to the same variables.
+    """
+    zero, unit = backend.zero(), backend.unit()
+    ext1, ext2 = extend(matrix1, index1), extend(matrix2, index2)
+    size = len(index1)
+
+    def entry(ext, i, j):
+        value = ext[i][j]
+        if value is None:
+            return unit if i == j else zero
+        return value
+
+    return [[entry(ext1, i, j) + entry(ext2, i, j)
+             for j in range(size)] for i in range(size)]
+
+
+def extended_prod(
+        matrix1: List[List[Polynomial]], index1: List[int],
+        matrix2: List[List[Polynomial]], index2: List[int]
+) -> List[List[Polynomial]]:
+    """Compute the product of two matrices that are implicitly identity
+    outside of their variables.
+
+    The result is the same as the [product](matrix.md#pymwp.matrix
+    .matrix_prod) of the inputs resized to the same variables, but terms
+    that are known to be $0$ are skipped: implicit entries are $0$ or
+    $m$, and $0$ times a polynomial without $\\infty$ is $0$.
+
+    Arguments:
+        matrix1: first polynomial matrix.
+        index1: position of each row of the result in `matrix1`, see
+            [`extend`](matrix.md#pymwp.matrix.extend)
+        matrix2: second polynomial matrix.
+        index2: position of each row of the result in `matrix2`
+
+    Returns:
+        new matrix of size `len(index1)`, equal to the product of the two
+            inputs resized to the same variables.
+    """
+    ext1, ext2 = extend(matrix1, index1), extend(matrix2, index2)
+    size = len(index1)
+    if workers.worthwhile(size):
+        return workers.map_rows(extended_rows, [ext1, ext2], size)
+    return extended_rows(ext1, ext2, range(size))
+
+
+def extended_rows(
+        ext1: List[List[Optional[Polynomial]]],
+        ext2: List[List[Optional[Polynomial]]], rows: range
+) -> List[List[Polynomial]]:
+    """Compute some rows of the product of two matrices that are
+    implicitly identity where their entries are `None`.
+
+    Arguments:
+        ext1: first matrix, see [`extend`](matrix.md#pymwp.matrix.extend)
+        ext2: second matrix
+        rows: rows of the product to compute
+
+    Returns:
+        listed rows of the product, see
+            [`extended_prod`](matrix.md#pymwp.matrix.extended_prod).
+    """
+    zero, unit = backend.zero(), backend.unit()
+    kernel = native.kernel()
+    if kernel is not None and backend.name() == 'list':
+        return kernel.extended_rows(ext1, ext2, rows, zero, unit)
+    size = len(ext1)
+    result = []
+    for i in rows:
+        row = []
+        for j in range(size):
+            total = zero
+            for k in range(size):
+                a, b = ext1[i][k], ext2[k][j]
+                if a is None:
+                    if i != k:
+                        if b is None or not b.eval:
+                            continue
+                        a = zero
+                    elif b is None:
+                        if k == j:
+                            total = total + unit
+                        continue
+                    else:
+                        a = unit
+                elif b is None:
+                    if k != j:
+                        if not a.eval:
+                            continue
+                        b = zero
+                    else:
+                        b = unit
+                total = total + (a * b)
+            row.append(total)
+        result.append(row)
+    return result
 
 
 def resize(matrix: List[List[Polynomial]], new_size: int) \
@@ -186,8 +345,7 @@ def resize(matrix: List[List[Polynomial]], new_size: int) \
     bound = min(new_size, len(matrix))
 
     for i in range(bound):
-        for j in range(bound):
-            res[i][j] = matrix[i][j]
+        res[i][:bound] = matrix[i][:bound]
     return res
 
 
@@ -301,3 +459,58 @@ def fixpoint(matrix: List[List[Any]]) -> List[List[Any]]:
         result = matrix_sum(result, next_matrix)
 
     return result
+
+
+def components(matrix: List[List[Any]]) -> List[List[int]]:
+    """Strongly connected components of the data-flow graph of a matrix.
+
+    The graph has an edge $i \\to j$ when `matrix[i][j]` is not the
+    0-polynomial, i.e. when variable $i$ flows into variable $j$.
+
+    Arguments:
+        matrix: square matrix
+
+    Returns:
+        Components as lists of indices, in topological order: edges
+            between components go from earlier to later components.
+    """
+    size, zero = len(matrix), backend.zero()
+    edges = [[j for j in range(size) if j != i and matrix[i][j] != zero]
+             for i in range(size)]
+    index, low, on_stack = [-1] * size, [0] * size, [False] * size
+    stack, result, counter = [], [], 0
+
+    for root in range(size):
+        if index[root] >= 0:
+            continue
+        work = [(root, 0)]
+        while work:
+            node, child = work.pop()
+            if child == 0:
+                index[node] = low[node] = counter
+                counter += 1
+                stack.append(node)
+                on_stack[node] = True
+            if child < len(edges[node]):
+                work.append((node, child + 1))
+                succ = edges[node][child]
+                if index[succ] < 0:
+                    work.append((succ, 0))
+                elif on_stack[succ]:
+                    low[node] = min(low[node], index[succ])
+                continue
+            if low[node] == index[node]:
+                component = []
+                while True:
+                    member = stack.pop()
+                    on_stack[member] = False
+                    component.append(member)
+                    if member == node:
+                        break
+                result.append(sorted(component))
+            if work:
+                parent = work[-1][0]
+                low[parent] = min(low[parent], low[node])
+
+    # Tarjan's algorithm finds components in reverse topological order
+    return result[::-1]
@@ -0,0 +1,583 @@
+# flake8: noqa: W605
+
+"""
+Polynomials as multi-valued decision diagrams.
+
+A polynomial maps each assignment of choices to delta indices
+(index $\\to \\{0,1,2\\}$) to a scalar: the sum of the scalars of the
+monomials whose deltas match the assignment. When no monomial matches, the
+value is undefined, written $\\bot$ here. Sum and product of polynomials
+act pointwise on these functions.
+
+[`MDDPolynomial`](mdd.md#pymwp.mdd.MDDPolynomial) represents this function
+as a reduced, ordered MDD: a node tests one delta index and has one child
+for each choice; terminals are $\\bot$ and the scalars. Nodes are
+hash-consed in a unique table, so two polynomials are equal iff they are
+the same node, and sum and product are computed with memoized apply
+operations, in time polynomial in diagram size.
+
+The diagram is an alternative to the list of monomials of
+[`Polynomial`](polynomial.md#pymwp.polynomial.Polynomial), which can grow
+exponentially. Its results are the same as those of the list polynomial:
+like [`remove_zeros`](polynomial.md#pymwp.polynomial.Polynomial.remove_zeros),
+sum and product turn $0$ values into $\\bot$, and a polynomial that is
+$\\bot$ everywhere into the constant $0$.
+
+Use [`backend`](backend.md) to select which polynomial the analysis uses.
+"""
+
+from __future__ import annotations
+
+import random
+from functools import cmp_to_key
+from typing import Iterable, Iterator, List, Optional, Sequence, Tuple, Union
+
+from .monomial import Monomial
+from .polynomial import Polynomial
+from .semiring import ZERO_MWP
+
+BOT, O, M, W, P, I = range(6)
+"""Terminal nodes: undefined, then scalars in increasing order."""
+
+TERMINALS = 6
+"""Number of terminal nodes; inner nodes have larger ids."""
+
+SCALARS = ['', 'o', 'm', 'w', 'p', 'i']
+"""Scalar of each terminal node."""
+
+TERMINAL = {s: n for n, s in enumerate(SCALARS) if s}
+"""Terminal node of each scalar."""
+
+LEAF = 1 << 30
+"""Index of terminals; larger than any delta index."""
+
+CHOICES = 3
+"""Number of choices at each delta index, i.e. children of a node."""
+
+
+def _prod(a: int, b: int) -> int:
+    if a == BOT or b == BOT:
+        return BOT
+    if a == O or b == O:
+        return I if a == I or b == I else O
+    return max(a, b)
+
+
+SUM_TABLE = tuple(tuple(max(a, b) for b in range(6)) for a in range(6))
+"""Scalar sum on terminals; $\\bot$ is neutral."""
+
+PROD_TABLE = tuple(tuple(_prod(a, b) for b in range(6)) for a in range(6))
+"""Scalar product on terminals; $\\bot$ is absorbing."""
+
+DIFF_TABLE = tuple(tuple(a if b == BOT else BOT for b in range(6))
+                   for a in range(6))
+"""Keep left terminal where right is $\\bot$; set difference of regions."""
+
+NO_ZEROS = (BOT, BOT, M, W, P, I)
+"""Terminal map that turns $0$ into $\\bot$."""
+
+INFINITY = (BOT, BOT, BOT, BOT, BOT, I)
+"""Terminal map that keeps only $\\infty$."""
+
+COMPLEMENT = (M, BOT, BOT, BOT, BOT, BOT)
+"""Terminal map from a region, i.e. where a diagram is not $\\bot$, to its
+complement."""
+
+
+class Manager:
+    """Unique table and operation caches of MDD nodes.
+
+    Node `n` is a terminal if `n < TERMINALS`, otherwise it tests delta
+    index `index[n]` and its children by choice are `kids[n]`.
+
+    Nodes are never freed one by one; the analysis of a function
+    [`releases`](#pymwp.mdd.Manager.release) the nodes it created, except
+    those of its resulting relation.
+    """
+
+    def __init__(self):
+        self.index: List[int] = [LEAF] * TERMINALS
+        self.kids: List[Optional[Tuple[int, ...]]] = [None] * TERMINALS
+        self.unique = {}
+        self.apply_cache = {}
+        self.map_cache = {}
+        self.cover_cache = {}
+
+    def __len__(self):
+        return len(self.index)
+
+    def clear_caches(self) -> None:
+        """Forget memoized operations; nodes remain valid."""
+        self.apply_cache.clear()
+        self.map_cache.clear()
+        self.cover_cache.clear()
+
+    def mark(self) -> int:
+        """Mark the current nodes, to [`release`](#pymwp.mdd.Manager
+        .release) the nodes created afterwards."""
+        return len(self.index)
+
+    def release(self, mark: int, polynomials: Iterable = ()) -> None:
+        """Forget nodes created since `mark`, except those of some
+        polynomials, and all memoized operations.
+
+        Nodes of `polynomials` are kept and renumbered, and the
+        polynomials are updated to refer to them; any other diagram
+        created since `mark` is no longer valid.
+
+        Arguments:
+            mark: value of [`mark`](#pymwp.mdd.Manager.mark)
+            polynomials: polynomials of either backend to keep
+        """
+        roots = [p for p in polynomials
+                 if isinstance(p, MDDPolynomial) and p.node >= mark]
+        reachable, stack = set(), [p.node for p in roots]
+        while stack:
+            n = stack.pop()
+            if n >= mark and n not in reachable:
+                reachable.add(n)
+                stack.extend(self.kids[n])
+        index, kids = self.index, self.kids
+        self.index, self.kids = index[:mark], kids[:mark]
+        self.unique = {k: n for k, n in self.unique.items() if n < mark}
+        self.clear_caches()
+        # children are created before their parents
+        moved = {}
+        for n in sorted(reachable):
+            moved[n] = self.node(index[n], tuple(
+                moved.get(k, k) for k in kids[n]))
+        # a polynomial may occur more than once
+        for p, n in [(p, moved[p.node]) for p in roots]:
+            p.node = n
+
+    def node(self, index: int, kids: Tuple[int, ...]) -> int:
+        """Get unique reduced node testing `index` with `kids`."""
+        first = kids[0]
+        if all(k == first for k in kids):
+            return first
+        key = (index, kids)
+        node = self.unique.get(key)
+        if node is None:
+            node = len(self.index)
+            self.index.append(index)
+            self.kids.append(kids)
+            self.unique[key] = node
+        return node
+
+    def cofactors(self, node: int, index: int) -> Tuple[int, ...]:
+        if self.index[node] == index:
+            return self.kids[node]
+        return (node,) * CHOICES
+
+    def apply(self, table: tuple, a: int, b: int) -> int:
+        """Combine two diagrams pointwise with terminal `table`."""
+        if a < TERMINALS and b < TERMINALS:
+            return table[a][b]
+        if table is SUM_TABLE:
+            if a == BOT or a == b:
+                return b
+            if b == BOT:
+                return a
+            if a == I or b == I:
+                return I
+        elif table is PROD_TABLE:
+            if a == BOT or b == BOT:
+                return BOT
+        elif a == BOT or b == BOT or a == b:  # difference
+            return BOT if b != BOT else a
+        if a > b and table is not DIFF_TABLE:  # sum and product commute
+            a, b = b, a
+        key = (id(table), a, b)
+        result = self.apply_cache.get(key)
+        if result is None:
+            index = min(self.index[a], self.index[b])
+            result = self.node(index, tuple(
+                self.apply(table, x, y) for x, y in zip(
+                    self.cofactors(a, index), self.cofactors(b, index))))
+            self.apply_cache[key] = result
+        return result
+
+    def map(self, table: tuple, node: int) -> int:
+        """Replace each terminal `t` of a diagram by `table[t]`."""
+        if node < TERMINALS:
+            return table[node]
+        key = (table, node)
+        result = self.map_cache.get(key)
+        if result is None:
+            result = self.node(self.index[node], tuple(
+                self.map(table, kid) for kid in self.kids[node]))
+            self.map_cache[key] = result
+        return result
+
+    def normalize(self, node: int) -> int:
+        """Turn $0$ into $\\bot$, and everywhere-$\\bot$ into $0$."""
+        node = self.map(NO_ZEROS, node)
+        return O if node == BOT else node
+
+    def monomial(self, scalar: str, deltas: List[Tuple[int, int]]) -> int:
+        """Diagram of one monomial: `scalar` where deltas match, else
+        $\\bot$."""
+        node = TERMINAL[scalar]
+        for value, index in reversed(deltas):
+            node = self.node(index, tuple(
+                node if v == value else BOT for v in range(CHOICES)))
+        return node
+
+    def paths(self, node: int) -> Iterator[Tuple[Tuple, int]]:
+        """Enumerate disjoint cubes: paths to terminals other than
+        $\\bot$, as (deltas, terminal) pairs."""
+        stack = [(node, ())]
+        while stack:
+            node, deltas = stack.pop()
+            if node < TERMINALS:
+                if node != BOT:
+                    yield deltas, node
+                continue
+            index = self.index[node]
+            for value, kid in reversed(list(enumerate(self.kids[node]))):
+                stack.append((kid, deltas + ((value, index),)))
+
+    def cover(self, node: int) -> Tuple[Tuple, ...]:
+        """Cover the region where a diagram is not $\\bot$ with cubes.
+
+        Unlike [`paths`](#pymwp.mdd.Manager.paths), cubes may overlap:
+        the part of the region common to all choices at a node is covered
+        without testing that node, which keeps cubes short and few.
+        """
+        if node < TERMINALS:
+            return () if node == BOT else ((),)
+        result = self.cover_cache.get(node)
+        if result is None:
+            index, kids = self.index[node], self.kids[node]
+            common = kids[0]
+            for kid in kids[1:]:
+                common = self.apply(PROD_TABLE, common, kid)
+            result = self.cover(common)
+            for value, kid in enumerate(kids):
+                rest = self.apply(DIFF_TABLE, kid, common)
+                result += tuple(((value, index),) + cube
+                                for cube in self.cover(rest))
+            self.cover_cache[node] = result
+        return result
+
+    def count(self, node: int, choices: Sequence[int], index: int,
+              level: int = 0) -> int:
+        """Count choice vectors of length `index`, with values in
+        `choices`, in the region where a diagram is not $\\bot$; only
+        indices from `level` on are counted."""
+        memo = {}
+
+        def below(n: int, level: int) -> int:
+            at = min(self.index[n], index)
+            skipped = len(choices) ** (at - level)
+            if n < TERMINALS:
+                return 0 if n == BOT else skipped
+            if n not in memo:
+                memo[n] = sum(below(self.kids[n][c], at + 1)
+                              for c in choices)
+            return skipped * memo[n]
+
+        return below(node, level)
+
+    def cubes(self, node: int, choices: Sequence[int], index: int) \
+            -> Iterator[List[List[int]]]:
+        """Enumerate disjoint cubes covering the region where a diagram is
+        not $\\bot$, as choice vectors of length `index`.
+
+        Each cube is one path of the diagram; choices at a node that lead
+        to the same child share an edge, and so one cube.
+        """
+        stack = [(node, ())]
+        while stack:
+            node, fixed = stack.pop()
+            if node < TERMINALS:
+                if node != BOT:
+                    vector = [list(choices) for _ in range(index)]
+                    for i, values in fixed:
+                        vector[i] = values
+                    yield vector
+                continue
+            edges = {}
+            for c in choices:
+                edges.setdefault(self.kids[node][c], []).append(c)
+            for kid, values in reversed(list(edges.items())):
+                if kid != BOT:
+                    stack.append((kid, fixed + ((self.index[node], values),)))
+
+    def sample(self, node: int, choices: Sequence[int], index: int,
+               rng: random.Random = random) -> Optional[List[int]]:
+        """Draw a choice vector uniformly at random from the region where
+        a diagram is not $\\bot$; `None` if the region is empty."""
+        vector = []
+        while len(vector) < index:
+            if self.index[node] > len(vector):
+                if node == BOT:
+                    return None
+                vector.append(rng.choice(choices))
+                continue
+            weights = [self.count(self.kids[node][c], choices, index,
+                                  len(vector) + 1) for c in choices]
+            if not any(weights):
+                return None
+            value = rng.choices(choices, weights)[0]
+            vector.append(value)
+            node = self.kids[node][value]
+        return vector if node != BOT else None
+
+    def size(self, node: int) -> int:
+        """Number of distinct nodes reachable from `node`."""
+        seen, stack = set(), [node]
+        while stack:
+            n = stack.pop()
+            if n not in seen:
+                seen.add(n)
+                if n >= TERMINALS:
+                    stack.extend(self.kids[n])
+        return len(seen)
+
+
+MANAGER = Manager()
+"""Manager shared by all diagram polynomials."""
+
+_compare = cmp_to_key(lambda m1, m2: Polynomial.compare(m1.deltas, m2.deltas))
+
+
+class MDDPolynomial:
+    """Polynomial represented as a node of a decision diagram.
+
+    It supports the operations of
+    [`Polynomial`](polynomial.md#pymwp.polynomial.Polynomial) that the
+    analysis uses, and can be used in its place.
+    """
+
+    __slots__ = ['node']
+
+    def __init__(self, monomials: Optional[Union[str, List[Monomial]]] = None):
+        """Create a polynomial.
+
+        Arguments are the same as for
+        [`Polynomial`](polynomial.md#pymwp.polynomial.Polynomial.__init__).
+
+        Arguments:
+            monomials: list of monomials, or scalar
+        """
+        if isinstance(monomials, str):
+            self.node = TERMINAL[monomials]
+        elif not monomials:
+            self.node = O
+        else:
+            node = BOT
+            for m in monomials:
+                node = MANAGER.apply(
+                    SUM_TABLE, node, MANAGER.monomial(m.scalar, m.deltas))
+            self.node = node
+
+    @staticmethod
+    def of(node: int) -> MDDPolynomial:
+        poly = MDDPolynomial.__new__(MDDPolynomial)
+        poly.node = node
+        return poly
+
+    @staticmethod
+    def of_scalar(scalar: str) -> MDDPolynomial:
+        """Constant polynomial of a scalar."""
+        return MDDPolynomial.of(TERMINAL[scalar])
+
+    def __str__(self):
+        values = ''.join(['+' + str(m) for m in self.list]) or ('+' + ZERO_MWP)
+        return "  " + values
+
+    def __eq__(self, other):
+        if isinstance(other, MDDPolynomial):
+            return self.node == other.node
+        return NotImplemented
+
+    def __hash__(self):
+        return self.node
+
+    def __add__(self, other):
+        return self.add(other)
+
+    def __mul__(self, other):
+        return self.times(other)
+
+    def add(self, polynomial: MDDPolynomial) -> MDDPolynomial:
+        """Add two polynomials."""
+        return MDDPolynomial.of(MANAGER.normalize(
+            MANAGER.apply(SUM_TABLE, self.node, polynomial.node)))
+
+    def times(self, polynomial: MDDPolynomial) -> MDDPolynomial:
+        """Multiply two polynomials."""
+        return MDDPolynomial.of(MANAGER.normalize(
+            MANAGER.apply(PROD_TABLE, self.node, polynomial.node)))
+
+    def equal(self, polynomial: MDDPolynomial) -> bool:
+        """Determine if two polynomials are equal, in constant time."""
+        return self.node == polynomial.node
+
+    def copy(self) -> MDDPolynomial:
+        """Polynomials are immutable; copy refers to the same node."""
+        return MDDPolynomial.of(self.node)
+
+    def show(self) -> None:
+        """Display polynomial."""
+        print(str(self))
+
+    @property
+    def size(self) -> int:
+        """Number of diagram nodes, including terminals."""
+        return MANAGER.size(self.node)
+
+    @property
+    def constant(self) -> Optional[str]:
+        """Scalar of a polynomial that does not depend on choices, or
+        `None`."""
+        return SCALARS[self.node] if O <= self.node <= I else None
+
+    @property
+    def list(self) -> List[Monomial]:
+        """Equivalent list of monomials, one for each disjoint cube."""
+        return sorted([Monomial(SCALARS[t], list(deltas))
+                       for deltas, t in MANAGER.paths(self.node)],
+                      key=_compare)
+
+    @property
+    def eval(self) -> List[Tuple]:
+        """Delta sequences that cover the choices whose scalar is
+        infinity."""
+        return list(MANAGER.cover(MANAGER.map(INFINITY, self.node)))
+
+    def while_correction(self, diagonal: bool) \
+            -> Tuple[MDDPolynomial, List[Tuple]]:
+        """Replace $p$, and $w$ if on the diagonal, by $\\infty$.
+
+        Arguments:
+            diagonal: polynomial is on the matrix diagonal
+
+        Returns:
+            Corrected polynomial and the delta sequences that became
+            infinite.
+        """
+        bad = (P, W) if diagonal else (P,)
+        changed = MANAGER.map(tuple(
+            I if t in bad else BOT for t in range(TERMINALS)), self.node)
+        if changed == BOT:
+            return self, []
+        corrected = MANAGER.map(tuple(
+            I if t in bad else t for t in range(TERMINALS)), self.node)
+        return MDDPolynomial.of(corrected), list(MANAGER.cover(changed))
+
+    @staticmethod
+    def from_scalars(index: int, *scalars: str) -> MDDPolynomial:
+        """Build polynomial that has scalar `scalars[k]` when choice at
+        `index` is `k`."""
+        kids = [TERMINAL[s] for s in scalars]
+        return MDDPolynomial.of(MANAGER.node(
+            index, tuple(kids + [BOT] * (CHOICES - len(kids)))))
+
+
+def infinity_of(polynomials: Iterable, node: int = BOT) -> int:
+    """Diagram of choices for which some polynomial is infinite.
+
+    Polynomials of either backend are accepted; list polynomials
+    contribute their recorded infinite monomials, so the cost is
+    proportional to the number of those monomials.
+
+    Arguments:
+        polynomials: polynomials to combine
+        node: diagram of choices already known to be infinite
+
+    Returns:
+        Diagram whose terminal is $\\infty$ at infinite choices, and
+        $\\bot$ elsewhere.
+    """
+    for poly in polynomials:
+        if node == I:
+            break
+        if isinstance(poly, MDDPolynomial):
+            node = MANAGER.apply(
+                SUM_TABLE, node, MANAGER.map(INFINITY, poly.node))
+        else:
+            for deltas in poly.eval:
+                node = MANAGER.apply(
+                    SUM_TABLE, node, MANAGER.monomial('i', deltas))
+    return node
+
+
+class ChoiceDiagram:
+    """Valid choices of an analysis, as a decision diagram.
+
+    The conditions under which some polynomial of a matrix is infinite are
+    combined into one diagram, with a sum; valid choices are the
+    complement of that region. This replaces reducing the set of infinite
+    delta sequences and negating them, as done by
+    [`Choices.generate`](choice.md#pymwp.choice.Choices.generate).
+    """
+
+    def __init__(self, choices: List[int], index: int, node: int = M):
+        """Create valid choices.
+
+        Arguments:
+            choices: list of valid choices for one index, e.g. [0,1,2]
+            index: the length of the vector, e.g. 10
+            node: diagram that is not $\\bot$ at valid choices
+        """
+        self.choices = list(choices)
+        self.index = index
+        self.node = node
+
+    @staticmethod
+    def of_polynomials(choices: List[int], index: int,
+                       polynomials: Iterable,
+                       infinity: int = BOT) -> ChoiceDiagram:
+        """Build valid choices from polynomials of either backend.
+
+        Arguments:
+            choices: list of valid choices for one index
+            index: the length of the vector
+            polynomials: polynomials whose infinity is not allowed
+            infinity: diagram of choices already known to be infinite
+
+        Returns:
+            Choices that give no infinite scalar in any polynomial, and
+            are not in `infinity`.
+        """
+        infinity = infinity_of(polynomials, infinity)
+        return ChoiceDiagram(
+            choices, index, MANAGER.map(COMPLEMENT, infinity))
+
+    @property
+    def infinite(self) -> bool:
+        """True if no choice is valid."""
+        return self.node == BOT
+
+    @property
+    def vectors(self) -> List[List[List[int]]]:
+        """Disjoint choice vectors that cover all valid choices."""
+        return list(MANAGER.cubes(self.node, self.choices, self.index))
+
+    def count(self) -> int:
+        """Number of valid choice sequences."""
+        return MANAGER.count(self.node, self.choices, self.index)
+
+    def sample(self, rng: random.Random = random) -> Optional[List[int]]:
+        """Draw valid choice sequence uniformly at random.
+
+        Arguments:
+            rng: source of randomness
+
+        Returns:
+            Choice at each index, or `None` if no choice is valid.
+        """
+        return MANAGER.sample(self.node, self.choices, self.index, rng)
+
+    def is_valid(self, *choices: int) -> bool:
+        """Check if some sequence of choices, that starts with `choices`,
+        is valid."""
+        node = self.node
+        for idx, value in enumerate(choices):
+            if node < TERMINALS or idx >= self.index:
+                break
+            if MANAGER.index[node] == idx:
+                node = MANAGER.kids[node][value]
+        return node != BOT
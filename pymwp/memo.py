@@ -0,0 +1,230 @@
+"""
+Memoized relations of statements.
+
+Generated and macro-expanded programs repeat the same statements many
+times, e.g. the same loop at many places, or the same block in both
+branches of an `if`. The relation of a statement only depends on its
+structure and on the delta index where its analysis starts: a statement
+analyzed at index $k$ instead of $j$ has the same relations, with every
+delta index moved by $k - j$.
+
+While a [`RelationCache`](memo.md#pymwp.memo.RelationCache) is active,
+[`Analysis.compute_relation`](analysis.md#pymwp.analysis.Analysis
+.compute_relation) looks statements up by their structure: the node type,
+its attributes, e.g. operators and variable names, and the structure of
+its children, but not its position in the source. On a hit, the cached
+relations are relocated to the current index instead of being computed
+again:
+
+- relations without deltas are kept as [scalars](scalars.md) and shared;
+- other relations are kept packed, see
+  [`pack_polynomial`](workers.md#pymwp.workers.pack_polynomial), and
+  decoded with moved delta indices.
+
+Only statements that contain other statements, and whose structure
+occurs more than once in the function, are cached; other statements are
+analyzed directly, without the cost of encoding their relations. A
+cached statement is analyzed with the [infinity store](infinity.md) of
+the function, through a [`Recorder`](memo.md#pymwp.memo.Recorder) that
+keeps the delta sequences it inserts; on a hit, they are relocated and
+inserted again. Statements whose analysis exits early are not cached.
+"""
+
+from __future__ import annotations
+
+from array import array
+from typing import Callable, Dict, Iterable, List, Optional, Tuple, Union
+
+from pycparser.c_ast import Node, If, While, For, Compound
+
+from .infinity import InfinityStore, SEQ
+from .relation import Relation
+from .relation_list import RelationList
+from .scalars import ScalarMatrix
+from .workers import pack_polynomial, unpack_polynomial
+
+CACHED = (If, While, For, Compound)
+"""Types of statements that are cached; an assignment or a call costs
+less to analyze again than to relocate."""
+
+RESULT = Tuple[int, RelationList, bool]
+"""Type hint for the result of the analysis of a statement."""
+
+FROZEN = Tuple[Tuple[str, ...], Union[ScalarMatrix, List[bytes]]]
+"""Type hint for a cached relation: variables, and scalars or packed
+polynomials by rows."""
+
+
+def freeze(relation: Relation) -> FROZEN:
+    """Encode relation so that it is not changed by later updates."""
+    scalars = relation.scalars
+    if scalars is not None:
+        return tuple(relation.variables), scalars
+    cells = []
+    for row in relation.matrix:
+        for poly in row:
+            values = array('I')
+            pack_polynomial(poly, values)
+            cells.append(values.tobytes())
+    return tuple(relation.variables), cells
+
+
+def thaw(frozen: FROZEN, offset: int) -> Relation:
+    """Decode relation encoded by [`freeze`](memo.md#pymwp.memo.freeze),
+    with delta indices moved by `offset`."""
+    variables, data = frozen
+    if isinstance(data, ScalarMatrix):
+        return Relation(list(variables), scalars=data)
+    polys = []
+    for cell in data:
+        values = array('I', cell)
+        polys.append(unpack_polynomial(values, 0, len(values), offset))
+    size = len(variables)
+    return Relation(list(variables),
+                    [polys[i * size:(i + 1) * size] for i in range(size)])
+
+
+def relocate(cubes: Tuple[SEQ, ...], offset: int) -> List[SEQ]:
+    """Move delta indices of delta sequences by `offset`."""
+    return [tuple((choice, index + offset) for choice, index in cube)
+            for cube in cubes]
+
+
+class Recorder:
+    """Infinity store of the enclosing analysis that also keeps the
+    delta sequences inserted through it."""
+
+    __slots__ = ['store', 'inserted']
+
+    def __init__(self, store: Union[InfinityStore, Recorder]):
+        """Create recorder.
+
+        Arguments:
+            store: store where sequences are inserted
+        """
+        self.store = store
+        self.inserted: List[SEQ] = []
+
+    def insert(self, deltas: SEQ) -> None:
+        """Insert sequence of deltas in the store, and keep it."""
+        self.store.insert(deltas)
+        self.inserted.append(deltas)
+
+    @property
+    def node(self) -> int:
+        return self.store.node
+
+    @property
+    def full(self) -> bool:
+        return self.store.full
+
+
+class Entry:
+    """Cached analysis of a statement."""
+
+    __slots__ = ['start', 'length', 'relations', 'cubes']
+
+    def __init__(self, start: int, length: int, relations: List[FROZEN],
+                 cubes: Tuple[SEQ, ...]):
+        """Create entry.
+
+        Arguments:
+            start: delta index where the analysis started
+            length: number of deltas of the statement
+            relations: relations of the statement
+            cubes: delta sequences the statement inserted in the
+                infinity store
+        """
+        self.start = start
+        self.length = length
+        self.relations = relations
+        self.cubes = cubes
+
+
+class RelationCache:
+    """Relations of analyzed statements, by structure."""
+
+    current: Optional[RelationCache] = None
+    """Cache that statements use; `None` when no cache is active."""
+
+    def __init__(self, nodes: Iterable[Node] = ()):
+        """Create cache.
+
+        Arguments:
+            nodes: statements that will be analyzed; only statements
+                whose structure occurs more than once among them, and
+                their children, are cached
+        """
+        self.keys: Dict[int, int] = {}
+        self.shapes: Dict[tuple, int] = {}
+        self.counts: Dict[int, int] = {}
+        self.entries: Dict[int, Entry] = {}
+        self.hits = 0
+        self.previous: Optional[RelationCache] = None
+        for node in nodes:
+            self.key(node)
+
+    def key(self, node: Node) -> int:
+        """Number of the structure of an AST node; structurally equal
+        nodes get the same number, and occurrences of each number are
+        counted."""
+        key = self.keys.get(id(node))
+        if key is None:
+            attrs = tuple(tuple(v) if isinstance(v, list) else v
+                          for v in (getattr(node, name)
+                                    for name in node.attr_names))
+            children = tuple((name, self.key(child))
+                             for name, child in node.children())
+            shape = (type(node), attrs, children)
+            key = self.shapes.setdefault(shape, len(self.shapes))
+            self.keys[id(node)] = key
+            self.counts[key] = self.counts.get(key, 0) + 1
+        return key
+
+    def relation(self, index: int, node: Node,
+                 store: Union[InfinityStore, Recorder],
+                 compute: Callable[[int, Node, InfinityStore], RESULT]) \
+            -> RESULT:
+        """Get relation of a statement from the cache, or compute it.
+
+        Arguments:
+            index: delta index
+            node: AST node to analyze
+            store: [choices leading to infinity](infinity.md)
+            compute: analysis of the node, called on a cache miss
+
+        Returns:
+            Updated index value, relation list, and an exit flag.
+        """
+        key = self.key(node)
+        if self.counts[key] < 2:
+            return compute(index, node, store)
+        entry = self.entries.get(key)
+        if entry is not None:
+            self.hits += 1
+            offset = index - entry.start
+            for cube in relocate(entry.cubes, offset):
+                store.insert(cube)
+            relations = [thaw(r, offset) for r in entry.relations]
+            return index + entry.length, \
+                RelationList(relation_list=relations), \
+                bool(entry.cubes) and store.full
+
+        recorder = Recorder(store)
+        end, rel_list, exit_ = compute(index, node, recorder)
+        if exit_:
+            return end, rel_list, True
+        self.entries[key] = Entry(
+            index, end - index, [freeze(r) for r in rel_list.relations],
+            tuple(recorder.inserted))
+        return end, rel_list, exit_
+
+    def __enter__(self) -> RelationCache:
+        """Make statements use this cache."""
+        self.previous = RelationCache.current
+        RelationCache.current = self
+        return self
+
+    def __exit__(self, *_) -> None:
+        RelationCache.current = self.previous
+        self.previous = None
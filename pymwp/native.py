@@ -0,0 +1,78 @@
+"""
+Optional native kernels of the polynomial algebra and choices.
+
+The sum and product of [list polynomials](polynomial.md), and the
+[matrix products](matrix.md) built on them, are also implemented as a
+C++ extension, `pymwp._algebra`, built from `src/algebra.cpp` when pymwp
+is installed. Reduction of delta sequences and generation of choice
+vectors in
+[`Choices.generate`](choice.md#pymwp.choice.Choices.generate) are
+implemented in `pymwp._choice`, built from `src/choice.cpp`. The
+analysis itself evaluates choices with a
+[`ChoiceDiagram`](mdd.md#pymwp.mdd.ChoiceDiagram) and does not call
+`Choices`, so `pymwp._choice` only serves the `Choices` API, e.g. for
+callers that still build choice vectors from delta sequences. Both are
+also built in place with:
+
+```
+python3 setup.py build_ext --inplace
+```
+
+The extensions compute the same results as the Python implementation,
+step by step, but keep monomials and delta sequences as packed arrays of
+deltas while they compute. When an extension is not available, e.g.
+because no C++ compiler was found at installation, the Python
+implementation is used. The extensions are also disabled while
+[counters](counters.md) are active, since they count the operations of
+the Python implementation.
+
+Example:
+
+```python
+native.available()  # True if extensions are installed
+native.use(False)   # compute in Python
+```
+"""
+
+from types import ModuleType
+from typing import Optional
+
+try:
+    from . import _algebra
+except ImportError:  # pragma: no cover
+    _algebra = None
+
+try:
+    from . import _choice
+except ImportError:  # pragma: no cover
+    _choice = None
+
+_enabled = _algebra is not None
+
+
+def available() -> bool:
+    """Check if the native extensions are installed."""
+    return _algebra is not None and _choice is not None
+
+
+def use(enabled: bool) -> None:
+    """Enable or disable native kernels, if available."""
+    global _enabled
+    _enabled = enabled and _algebra is not None
+
+
+def kernel() -> Optional[ModuleType]:
+    """Get native polynomial algebra, or `None` when kernels run in
+    Python."""
+    return _algebra if _enabled else None
+
+
+def choice_kernel() -> Optional[ModuleType]:
+    """Get native choice reduction, or `None` when it runs in Python."""
+    return _choice if _enabled else None
+
+
+def register(monomial: type, polynomial: type) -> None:
+    """Let the extension create monomials and polynomials."""
+    if _algebra is not None:
+        _algebra.init(monomial, polynomial)
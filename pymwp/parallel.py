@@ -0,0 +1,135 @@
+"""
+Parallel composition of long statement sequences.
+
+By default, statements of a function body are composed one at a time.
+When more than one job is allowed, and a function body has at least
+`MIN_STATEMENTS` statements, the analysis first computes the relation
+lists of all statements, then
+[`compose_tree`](parallel.md#pymwp.parallel.compose_tree) composes them
+as a balanced binary tree: consecutive statements are split into chunks,
+each chunk is composed in a worker process, and results are then composed
+pairwise, level by level, in the same workers. Composition is
+associative, so the result is the same as sequential composition.
+
+Relations are sent between processes in a compact encoding, see
+[`pack`](parallel.md#pymwp.parallel.pack), rather than as pickled
+polynomial and monomial objects. The number of jobs is set in
+[`workers`](workers.md).
+"""
+
+from array import array
+from typing import List, Tuple
+
+from . import backend
+from .planner import compose_chain
+from .relation import Relation
+from .relation_list import RelationList
+from .stats import timed
+from .variables import VariableTable
+from .workers import jobs, pack_polynomial, pool, unpack_polynomial
+
+MIN_STATEMENTS = 64
+"""Least number of statements composed as a tree."""
+
+MIN_CHUNK = 8
+"""Least number of statements composed by one worker."""
+
+PACKED = List[Tuple[Tuple[str, ...], List[bytes]]]
+"""Type hint for a packed relation list."""
+
+
+def worthwhile(statements: int) -> bool:
+    """Check if a sequence of statements is composed as a tree."""
+    return jobs() > 1 and statements >= MIN_STATEMENTS
+
+
+def pack(rel_list: RelationList) -> PACKED:
+    """Encode relation list compactly.
+
+    Each relation is encoded as its variables and one byte string per
+    polynomial, which holds for each monomial its scalar, number of
+    deltas, and deltas, as unsigned integers.
+
+    Arguments:
+        rel_list: relation list to encode
+
+    Returns:
+        Encoded relation list, see [`unpack`](parallel.md#pymwp.parallel
+            .unpack).
+    """
+    result = []
+    for relation in rel_list.relations:
+        cells = []
+        for row in relation.matrix:
+            for poly in row:
+                values = array('I')
+                pack_polynomial(poly, values)
+                cells.append(values.tobytes())
+        result.append((tuple(relation.variables), cells))
+    return result
+
+
+def unpack(data: PACKED) -> RelationList:
+    """Decode relation list encoded by
+    [`pack`](parallel.md#pymwp.parallel.pack).
+
+    Arguments:
+        data: encoded relation list
+
+    Returns:
+        Relation list, whose polynomials use the selected backend.
+    """
+    relations = []
+    for variables, cells in data:
+        size = len(variables)
+        polys = []
+        for cell in cells:
+            values = array('I', cell)
+            polys.append(unpack_polynomial(values, 0, len(values)))
+        matrix = [polys[i * size:(i + 1) * size] for i in range(size)]
+        relations.append(Relation(list(variables), matrix))
+    return RelationList(relation_list=relations)
+
+
+def compose_packed(name: str, chain: List[PACKED]) -> PACKED:
+    """Compose encoded relation lists in a worker process.
+
+    Arguments:
+        name: polynomial backend name
+        chain: encoded relation lists, in the order of their statements
+
+    Returns:
+        Encoded composition.
+    """
+    if backend.name() != name:
+        backend.use(name)
+    with VariableTable():
+        return pack(compose_chain([unpack(data) for data in chain]))
+
+
+@timed('compose_tree')
+def compose_tree(rel_lists: List[RelationList],
+                 chunk: int = MIN_CHUNK) -> RelationList:
+    """Compose relation lists of consecutive statements in parallel.
+
+    Arguments:
+        rel_lists: relation lists, in the order of their statements
+        chunk: least number of statements composed by one worker
+
+    Returns:
+        Relation list of their composition.
+    """
+    if not rel_lists:
+        return RelationList()
+    name = backend.name()
+    size = max(chunk, -(-len(rel_lists) // jobs()))
+    level = [[pack(rel_list) for rel_list in rel_lists[i:i + size]]
+             for i in range(0, len(rel_lists), size)]
+    while len(level) > 1 or len(level[0]) > 1:
+        # a chunk without a pair at the end is carried to next level
+        tasks = [pool().submit(compose_packed, name, chain)
+                 if len(chain) > 1 else None for chain in level]
+        results = [task.result() if task else chain[0]
+                   for task, chain in zip(tasks, level)]
+        level = [results[i:i + 2] for i in range(0, len(results), 2)]
+    return unpack(level[0][0])
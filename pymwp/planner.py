@@ -0,0 +1,126 @@
+"""
+Order of composition for a sequence of statements.
+
+Composition is associative, so the relations of a sequence of statements
+can be composed in any grouping. Instead of folding them one at a time
+into an accumulator,
+[`compose_chain`](planner.md#pymwp.planner.compose_chain) chooses the
+grouping, as for a chain of matrix products, that minimizes the estimated
+cost of the compositions: relations with few variables in common, or
+with small polynomials, are composed first.
+
+The cost of composing relations over variables $A$ and $B$, whose
+polynomials have on average $s_A$ and $s_B$ monomials, is estimated as
+$|A \\cup B|^2 \\cdot (|A \\cap B| + 1) \\cdot s_A \\cdot s_B$, multiplied
+by the number of relations in each list. Long sequences are planned in
+segments of at most `SEGMENT` statements, which are then composed in
+order.
+"""
+
+from __future__ import annotations
+
+from typing import FrozenSet, List, Tuple
+
+from .relation_list import RelationList
+from .stats import timed
+
+SEGMENT = 16
+"""Maximum number of relation lists whose order is planned at once."""
+
+FACTOR = Tuple[FrozenSet[str], float]
+"""Type hint for variables and average polynomial size of a factor."""
+
+
+def footprint(rel_list: RelationList) -> FACTOR:
+    """Variables and average polynomial size of a relation list, weighed
+    by the number of relations in the list."""
+    variables, cells, size = set(), 0, 0
+    for relation in rel_list.relations:
+        variables.update(relation.variables)
+        if relation.scalars is not None:
+            # one monomial per polynomial, without building polynomials
+            cells += len(relation.variables) ** 2
+            size += len(relation.variables) ** 2
+            continue
+        for row in relation.matrix:
+            cells += len(row)
+            size += sum(poly.size for poly in row)
+    return frozenset(variables), \
+        max(1.0, size / max(cells, 1)) * len(rel_list.relations)
+
+
+def cost(a: FACTOR, b: FACTOR) -> Tuple[float, FACTOR]:
+    """Estimate cost of composing two factors, and the resulting factor."""
+    union = a[0] | b[0]
+    common = len(a[0] & b[0])
+    return len(union) ** 2 * (common + 1) * a[1] * b[1], \
+        (union, a[1] * b[1])
+
+
+def plan(factors: List[FACTOR]) -> List[List[int]]:
+    """Find the cheapest grouping of a chain of compositions.
+
+    Arguments:
+        factors: variables and size of each factor of the chain
+
+    Returns:
+        Table `split`, where `split[i][j]` is the position at which the
+            product of factors `i..j` is split in two.
+    """
+    n = len(factors)
+    best = [[0.0] * n for _ in range(n)]
+    result = [[None] * n for _ in range(n)]
+    split = [[i] * n for i in range(n)]
+    for i, factor in enumerate(factors):
+        result[i][i] = factor
+    for length in range(2, n + 1):
+        for i in range(n - length + 1):
+            j = i + length - 1
+            for k in range(i, j):
+                step, factor = cost(result[i][k], result[k + 1][j])
+                total = best[i][k] + best[k + 1][j] + step
+                if result[i][j] is None or total < best[i][j]:
+                    best[i][j], result[i][j], split[i][j] = \
+                        total, factor, k
+    return split
+
+
+def compose(rel_lists: List[RelationList], split: List[List[int]],
+            i: int, j: int) -> RelationList:
+    """Compose relation lists `i..j` grouped as planned."""
+    if i == j:
+        return rel_lists[i]
+    k = split[i][j]
+    result = compose(rel_lists, split, i, k)
+    if k == i:
+        result = RelationList(relation_list=result.relations[:])
+    result.composition(compose(rel_lists, split, k + 1, j))
+    return result
+
+
+@timed('compose_chain')
+def compose_chain(rel_lists: List[RelationList]) -> RelationList:
+    """Compose relation lists of consecutive statements.
+
+    Arguments:
+        rel_lists: relation lists, in the order of their statements
+
+    Returns:
+        Relation list of their composition, with the same relations as
+            when composing them one at a time starting from an empty
+            relation.
+    """
+    result = None
+    for start in range(0, len(rel_lists), SEGMENT):
+        segment = rel_lists[start:start + SEGMENT]
+        split = plan([footprint(rel_list) for rel_list in segment])
+        product = compose(segment, split, 0, len(segment) - 1)
+        if result is not None:
+            result.composition(product)
+        elif len(segment) > 1:
+            # product already combines every polynomial
+            result = product
+        else:
+            result = RelationList()
+            result.composition(product)
+    return result or RelationList()
@@ -3,11 +3,13 @@
 from __future__ import annotations
 
 import logging
+from functools import cmp_to_key
 from typing import Optional, List, Tuple, Union
 
+from . import native
 from .constants import Comparison, SetInclusion
 from .monomial import Monomial
-from .semiring import ZERO_MWP, sum_mwp
+from .semiring import KEYS, ZERO_MWP, prod_mwp, sum_mwp
 
 logger = logging.getLogger(__name__)
 
@@ -63,6 +65,7 @@ class Polynomial:
             self.list = [Monomial(monomials)]
         else:
             self.list = monomials or [Monomial(ZERO_MWP)]
+        self.infinite: Optional[List[Tuple]] = None
 
     def __str__(self):
         values = ''.join(['+' + str(m) for m in self.list]) or ('+' + ZERO_MWP)
@@ -78,10 +81,31 @@ class Polynomial:
         return self.times(other)
 
     @property
-    def eval(self):
-        """List of monomial deltas whose scalar is infinity."""
-        return [tuple(mono.deltas) for mono in
-                [m for m in self.list if m.scalar == 'i']]
+    def size(self) -> int:
+        """Number of monomials."""
+        return len(self.list)
+
+    @property
+    def constant(self) -> Optional[str]:
+        """Scalar of a polynomial made of one monomial without deltas, or
+        `None`."""
+        if len(self.list) == 1 and not self.list[0].deltas:
+            return self.list[0].scalar
+        return None
+
+    @property
+    def eval(self) -> List[Tuple]:
+        """List of monomial deltas whose scalar is infinity.
+
+        The list is kept in `self.infinite`: sum, product and while
+        correction record it while building their result, so reading it
+        afterwards does not scan the monomials again. Do not modify the
+        returned list.
+        """
+        if self.infinite is None:
+            self.infinite = [tuple(m.deltas) for m in self.list
+                             if m.scalar == 'i']
+        return self.infinite
 
     @staticmethod
     def inclusion(list_monom: list, mono: Monomial, i: int = 0) \
@@ -145,6 +169,13 @@ class Polynomial:
             return polynomial.copy()
         if not polynomial.list:
             return self.copy()
+        a, b = self.constant, polynomial.constant
+        if a is not None and b is not None:
+            return Polynomial.of_scalar(sum_mwp(a, b))
+        kernel = native.kernel()
+        if kernel is not None:
+            return Polynomial.of_native(
+                *kernel.add(self.list, polynomial.list))
 
         i, j = 0, 0
         new_list = self.copy().list
@@ -239,6 +270,16 @@ class Polynomial:
             a new polynomial that is the sorted product
             of the two input polynomials
         """
+        a, b = self.constant, polynomial.constant
+        if a is not None and b is not None:
+            return Polynomial.of_scalar(prod_mwp(a, b))
+        if a is not None or b is not None:
+            return self.scale(polynomial)
+
+        kernel = native.kernel()
+        if kernel is not None:
+            return Polynomial.of_native(
+                *kernel.times(self.list, polynomial.list))
 
         # 1: compute table of products
         # here we compute P1 x P2 for each polynomial, excluding from the
@@ -293,6 +334,49 @@ class Polynomial:
 
         return Polynomial(result).remove_zeros()
 
+    def scale(self, polynomial: Polynomial) -> Polynomial:
+        """Multiply two polynomials, one of which is a
+        [constant](polynomial.md#pymwp.polynomial.Polynomial.constant).
+
+        The result is the same as that of
+        [`times`](polynomial.md#pymwp.polynomial.Polynomial.times), which
+        here has one product per monomial of the other polynomial, but
+        the products are ordered by a sort instead of a table of indices.
+
+        Arguments:
+            polynomial: polynomial to multiply with self
+
+        Returns:
+            a new polynomial that is the sorted product
+            of the two input polynomials
+        """
+        kernel = native.kernel()
+        if kernel is not None:
+            return Polynomial.of_native(
+                *kernel.scale(self.list, polynomial.list))
+        constant = self.constant
+        scalar, other = (constant, polynomial) if constant is not None \
+            else (polynomial.list[0].scalar, self)
+        # a product with a constant only changes scalars; monomials whose
+        # scalar does not change are shared
+        products = []
+        for mono in other.list:
+            product = prod_mwp(scalar, mono.scalar)
+            if product == ZERO_MWP:
+                continue
+            products.append(mono if product == mono.scalar
+                            else Monomial(product, mono.deltas))
+        if constant is not None:
+            products.sort(key=_by_deltas)
+        if not products:
+            return Polynomial.of_scalar(ZERO_MWP)
+        result = []
+        for mono in products:
+            tobe_inserted, _ = Polynomial.inclusion(result, mono)
+            if tobe_inserted:
+                result.append(mono)
+        return Polynomial(result).remove_zeros()
+
     def equal(self, polynomial: Polynomial) -> bool:
         """Determine if two polynomials are equal.
 
@@ -326,7 +410,9 @@ class Polynomial:
 
     def copy(self) -> Polynomial:
         """Make a deep copy of polynomial."""
-        return Polynomial([m.copy() for m in self.list])
+        poly = Polynomial([m.copy() for m in self.list])
+        poly.infinite = self.infinite
+        return poly
 
     def show(self) -> None:
         """Display polynomial."""
@@ -471,16 +557,70 @@ class Polynomial:
             polynomial with list of monomials for which zeros are
             removed, unless 0 is the only monomial.
         """
-        filtered_monomials = list(filter(
-            lambda mono: mono.scalar != ZERO_MWP, self.list))
+        filtered_monomials, infinite = [], []
+        for mono in self.list:
+            if mono.scalar != ZERO_MWP:
+                filtered_monomials.append(mono)
+                if mono.scalar == 'i':
+                    infinite.append(tuple(mono.deltas))
 
         if len(filtered_monomials) == 0:
             self.list = [Monomial(ZERO_MWP)]
         else:
             self.list = filtered_monomials
+        self.infinite = infinite
 
         return self
 
+    def while_correction(self, diagonal: bool) \
+            -> Tuple[Polynomial, List[Tuple]]:
+        """Replace scalar $p$, and $w$ if on the diagonal, by $\\infty$.
+
+        Arguments:
+            diagonal: polynomial is on the matrix diagonal
+
+        Polynomials and monomials are shared, e.g. the
+        [constants](polynomial.md#pymwp.polynomial.Polynomial.of_scalar),
+        so when a monomial becomes infinite, the result is a new
+        polynomial, with a new monomial in its place.
+
+        Returns:
+            Corrected polynomial, self if nothing changed, and deltas of
+            the monomials that became infinite.
+        """
+        monomials, changed, infinite = None, [], []
+        for k, mon in enumerate(self.list):
+            if mon.scalar == "p" or (mon.scalar == "w" and diagonal):
+                corrected = Monomial("i")
+                corrected.deltas = mon.deltas[:]
+                if monomials is None:
+                    monomials = self.list[:]
+                monomials[k] = mon = corrected
+                changed.append(tuple(mon.deltas))
+            if mon.scalar == "i":
+                infinite.append(tuple(mon.deltas))
+        poly = self if monomials is None else Polynomial(monomials)
+        poly.infinite = infinite
+        return poly, changed
+
+    @staticmethod
+    def of_scalar(scalar: str) -> Polynomial:
+        """Constant polynomial, with its infinite monomials recorded.
+
+        There is one constant polynomial for each scalar, shared by all
+        results; it must not be modified.
+        """
+        return CONSTANTS[scalar]
+
+    @staticmethod
+    def of_native(monomials: List[Monomial], infinite: List[Tuple]) \
+            -> Polynomial:
+        """Polynomial computed by [native kernels](native.md), with its
+        infinite monomials already recorded."""
+        poly = Polynomial(monomials)
+        poly.infinite = infinite
+        return poly
+
     @staticmethod
     def from_scalars(index: int, *scalars: str) -> Polynomial:
         """Build a polynomial of multiple monomials with deltas.
@@ -512,3 +652,21 @@ class Polynomial:
         monomials = [Monomial(scalar, [(number, index)])
                      for number, scalar in enumerate(scalars)]
         return Polynomial(monomials)
+
+
+_by_deltas = cmp_to_key(
+    lambda m1, m2: Polynomial.compare(m1.deltas, m2.deltas) - 1)
+"""Sort key of monomials by their deltas."""
+
+
+def _constant(scalar: str) -> Polynomial:
+    poly = Polynomial(scalar)
+    poly.infinite = [()] if scalar == 'i' else []
+    return poly
+
+
+CONSTANTS = {scalar: _constant(scalar) for scalar in KEYS}
+"""Shared constant polynomial of each scalar, see
+[`of_scalar`](polynomial.md#pymwp.polynomial.Polynomial.of_scalar)."""
+
+native.register(Monomial, Polynomial)
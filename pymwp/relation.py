@@ -5,9 +5,13 @@ from __future__ import annotations
 import logging
 from typing import Optional, Tuple, List
 
-from . import matrix as matrix_utils
-from .delta_graphs import DeltaGraph
+from . import backend, matrix as matrix_utils
 from .choice import Choices
+from .infinity import InfinityStore
+from .variables import VariableTable
+from .mdd import BOT, I, ChoiceDiagram, infinity_of
+from .scalars import ScalarMatrix
+from .stats import span, timed
 
 logger = logging.getLogger(__name__)
 
@@ -25,7 +29,8 @@ class Relation:
     """
 
     def __init__(self, variables: Optional[List[str]] = None,
-                 matrix: Optional[List[List]] = None):
+                 matrix: Optional[List[List]] = None,
+                 scalars: Optional[ScalarMatrix] = None):
         """Create a relation.
 
         When constructing a relation, provide a list of variables
@@ -52,13 +57,21 @@ class Relation:
         #  X2  |  0  0  0
         ```
 
+        While a [`VariableTable`](variables.md) is active, the relation
+        shares it, and is implicitly identity outside of its variables.
+
         Arguments:
             variables: program variables
             matrix: relation matrix
+            scalars: relation matrix as scalars, instead of `matrix`
         """
         self.variables = (variables or [])[:]
-        self.matrix = matrix or matrix_utils \
-            .init_matrix(len(self.variables))
+        self._matrix = None
+        self._scalars = scalars
+        if scalars is None:
+            self.matrix = matrix or matrix_utils \
+                .init_matrix(len(self.variables))
+        self.table = VariableTable.current
 
     @staticmethod
     def identity(variables: List) -> Relation:
@@ -93,9 +106,38 @@ class Relation:
         matrix = matrix_utils.identity_matrix(len(variables))
         return Relation(variables, matrix)
 
+    @property
+    def matrix(self) -> List[List]:
+        """Matrix of polynomials.
+
+        A relation whose matrix is kept as scalars creates its
+        polynomials when the matrix is read, and then stops using the
+        scalars, since the matrix may be updated in place.
+        """
+        if self._matrix is None:
+            self._matrix = self._scalars.polynomials()
+        if self._scalars:
+            self._scalars = None
+        return self._matrix
+
+    @matrix.setter
+    def matrix(self, matrix: List[List]) -> None:
+        self._matrix, self._scalars = matrix, None
+
+    @property
+    def scalars(self) -> Optional[ScalarMatrix]:
+        """Matrix as [scalars](scalars.md), when no polynomial has
+        deltas; otherwise `None`."""
+        if self._scalars is None:
+            found = ScalarMatrix.of(self._matrix)
+            self._scalars = False if found is None else found
+        return self._scalars or None
+
     @property
     def is_empty(self):
-        return not self.variables or not self.matrix
+        if self._matrix is None:
+            return not self.variables or not self._scalars.size
+        return not self.variables or not self._matrix
 
     def __str__(self):
         right_pad = len(max(self.variables, key=len)) \
@@ -133,7 +175,7 @@ class Relation:
 
         return new_relation
 
-    def while_correction(self, dg: DeltaGraph) -> None:
+    def while_correction(self, store: InfinityStore) -> None:
         """Replace invalid scalars in a matrix by $\\infty$.
 
         Following the computation of fixpoint for a while loop node, this
@@ -161,14 +203,21 @@ class Relation:
         https://github.com/statycc/pymwp/issues/14).
 
         Arguments:
-            dg: DeltaGraph instance
+            store: where to record delta sequences that became $\\infty$
         """
+        scalars = self.scalars
+        if scalars is not None:
+            self._scalars, changed = scalars.while_correction()
+            self._matrix = None
+            if changed:
+                # every choice leads to infinity
+                store.insert(())
+            return
         for i, vector in enumerate(self.matrix):
             for j, poly in enumerate(vector):
-                for mon in poly.list:
-                    if mon.scalar == "p" or (mon.scalar == "w" and i == j):
-                        mon.scalar = "i"
-                        dg.import_monomial(mon)
+                vector[j], infinite = poly.while_correction(i == j)
+                for deltas in infinite:
+                    store.insert(deltas)
 
     def sum(self, other: Relation) -> Relation:
         """Sum two relations.
@@ -181,6 +230,13 @@ class Relation:
         Returns:
            A new relation that is a sum of inputs.
         """
+        if self.scalars is not None and other.scalars is not None:
+            variables, s1, s2 = self.scalar_operands(other)
+            return Relation(variables, scalars=s1 + s2)
+        if self.shares_table(other):
+            variables, index1, index2 = self.common_variables(other)
+            return Relation(variables, matrix_utils.extended_sum(
+                self.matrix, index1, other.matrix, index2))
         er1, er2 = Relation.homogenisation(self, other)
         new_matrix = matrix_utils.matrix_sum(er1.matrix, er2.matrix)
         return Relation(er1.variables, new_matrix)
@@ -204,6 +260,13 @@ class Relation:
         """
 
         logger.debug("starting composition...")
+        if self.scalars is not None and other.scalars is not None:
+            variables, s1, s2 = self.scalar_operands(other)
+            return Relation(variables, scalars=s1 * s2)
+        if self.shares_table(other):
+            variables, index1, index2 = self.common_variables(other)
+            return Relation(variables, matrix_utils.extended_prod(
+                self.matrix, index1, other.matrix, index2))
         er1, er2 = Relation.homogenisation(self, other)
         logger.debug("composing matrix product...")
         new_matrix = matrix_utils.matrix_prod(er1.matrix, er2.matrix)
@@ -234,6 +297,10 @@ class Relation:
         if set(self.variables) != set(other.variables):
             return False
 
+        if self.scalars is not None and other.scalars is not None:
+            _, s1, s2 = self.scalar_operands(other)
+            return s1 == s2
+
         # not sure homogenisation is necessary here
         # --> yes we need it
         er1, er2 = Relation.homogenisation(self, other)
@@ -248,24 +315,107 @@ class Relation:
         """
         Compute sum of compositions until no changes occur.
 
+        When the data-flow graph of the matrix has several strongly
+        connected components, the sum is computed per component, see
+        [`decomposed_fixpoint`](relation.md#pymwp.relation.Relation
+        .decomposed_fixpoint).
+
+        Returns:
+            resulting relation.
+        """
+        if self.scalars is not None:
+            return self.iterated_fixpoint()
+        if len(self.variables) > 1 and not self.infinity:
+            parts = matrix_utils.components(self.matrix)
+            if len(parts) > 1:
+                return self.decomposed_fixpoint(parts)
+        return self.iterated_fixpoint()
+
+    def iterated_fixpoint(self) -> Relation:
+        """
+        Compute sum of compositions of the whole matrix until no changes
+        occur.
+
         Returns:
             resulting relation.
         """
         fix_vars = self.variables
+        if self.scalars is not None:
+            return Relation(fix_vars, scalars=self.scalars.closure())
         matrix = matrix_utils.identity_matrix(len(fix_vars))
         fix = Relation(fix_vars, matrix)
         prev_fix = Relation(fix_vars, matrix)
         current = Relation(fix_vars, matrix)
 
-        logger.debug(f"computing fixpoint for variables {fix_vars}")
+        logger.debug("computing fixpoint for variables %s", fix_vars)
 
+        iteration = 0
         while True:
-            prev_fix.matrix = fix.matrix
-            current = current * self
-            fix = fix + current
-            if fix.equal(prev_fix):
-                logger.debug(f"fixpoint done {fix_vars}")
-                return fix
+            with span('fixpoint_iteration', iteration=iteration,
+                      matrix_size=len(fix_vars)):
+                prev_fix.matrix = fix.matrix
+                current = current * self
+                fix = fix + current
+                if fix.equal(prev_fix):
+                    logger.debug("fixpoint done %s", fix_vars)
+                    return fix
+            iteration += 1
+
+    def decomposed_fixpoint(self, parts: List[List[int]]) -> Relation:
+        """Compute fixpoint one strongly connected component at a time.
+
+        Components are visited in topological order. The fixpoint of
+        each component is iterated on its own rows and columns only; flows
+        that enter the component from earlier components are then
+        combined with it by one product:
+
+        $$X_{iB} = \\Big(\\sum_{k} X_{ik} M_{kB}\\Big) \\cdot M_{BB}^*$$
+
+        where $k$ ranges over variables of earlier components. The result
+        equals the iterated fixpoint when the matrix has no $\\infty$,
+        since then $0$ times any polynomial is $0$; the caller checks
+        this.
+
+        Arguments:
+            parts: components of the data-flow graph, in topological order
+
+        Returns:
+            resulting relation.
+        """
+        zero, size = backend.zero(), len(self.variables)
+        result = [[zero] * size for _ in range(size)]
+        done = []
+        for part in parts:
+            closure = Relation(
+                [self.variables[i] for i in part],
+                [[self.matrix[i][j] for j in part] for i in part]
+            ).iterated_fixpoint().matrix
+            for a, i in enumerate(part):
+                for b, j in enumerate(part):
+                    result[i][j] = closure[a][b]
+            members = set(part)
+            for i in range(size):
+                if i in members:
+                    continue
+                # flows from i into the component, through earlier ones
+                entry = [zero] * len(part)
+                for k in done:
+                    if result[i][k] == zero:
+                        continue
+                    for b, j in enumerate(part):
+                        if self.matrix[k][j] != zero:
+                            entry[b] = entry[b] + \
+                                result[i][k] * self.matrix[k][j]
+                if all(e == zero for e in entry):
+                    continue
+                for b, j in enumerate(part):
+                    total = zero
+                    for a in range(len(part)):
+                        if entry[a] != zero:
+                            total = total + entry[a] * closure[a][b]
+                    result[i][j] = total
+            done.extend(part)
+        return Relation(self.variables, result)
 
     def to_dict(self) -> dict:
         """Get dictionary representation of a relation."""
@@ -278,6 +428,62 @@ class Relation:
         """Display relation."""
         print(str(self))
 
+    def shares_table(self, other: Relation) -> bool:
+        """Check if two relations share a variable table, so that they
+        can be combined without homogenisation."""
+        return self.table is not None and self.table is other.table
+
+    def common_variables(self, other: Relation) \
+            -> Tuple[List[str], List[int], List[int]]:
+        """Find the variables of a combination of relations that share a
+        variable table.
+
+        Variables are ordered as by
+        [`homogenisation`](relation.md#pymwp.relation.Relation.homogenisation):
+        variables of `self`, then the other variables of `other`.
+
+        Arguments:
+            other: relation that shares variable table with `self`
+
+        Returns:
+            Combined variables, and the position of each of them in `self`
+            and in `other`, or -1 where the relation is implicitly
+            identity.
+        """
+        table = self.table
+        pos1, pos2 = table.positions(self.variables, other.variables)
+        variables = self.variables + [
+            v for v in other.variables if pos1[table.ids[v]] < 0]
+        ids = [table.ids[v] for v in variables]
+        return variables, [pos1[i] for i in ids], [pos2[i] for i in ids]
+
+    def scalar_operands(self, other: Relation) \
+            -> Tuple[List[str], ScalarMatrix, ScalarMatrix]:
+        """Scalar matrices of two relations, over the same variables.
+
+        Variables are combined as in
+        [`homogenisation`](relation.md#pymwp.relation.Relation
+        .homogenisation), and both relations are identity outside of
+        their own variables.
+
+        Arguments:
+            other: relation whose matrix is also kept as scalars
+
+        Returns:
+            Combined variables, and the two scalar matrices.
+        """
+        if self.shares_table(other):
+            variables, index1, index2 = self.common_variables(other)
+        else:
+            variables = self.variables + [
+                v for v in other.variables if v not in self.variables]
+            position = {v: i for i, v in enumerate(other.variables)}
+            index1 = [i if i < len(self.variables) else -1
+                      for i in range(len(variables))]
+            index2 = [position.get(v, -1) for v in variables]
+        return variables, self.scalars.embed(index1), \
+            other.scalars.embed(index2)
+
     @staticmethod
     def homogenisation(r1: Relation, r2: Relation) \
             -> Tuple[Relation, Relation]:
@@ -325,30 +531,84 @@ class Relation:
         # index of each extended_vars iff variable exists in r2.
         # we will use this to mapping from old -> new matrix to fill
         # the new matrix; the indices may be in different order.
-        index_dict = {index: r2.variables.index(var)
-                      for index, var in enumerate(extended_vars)
-                      if var in r2.variables}
-
-        # generate a list of all valid <row, column> combinations
-        index_map = [t1 + t2 for t1 in index_dict.items()
-                     for t2 in index_dict.items()]
-
-        # fill the resized matrix with values from original matrix
-        for mj, rj, mi, ri in index_map:
-            matrix2[mi][mj] = r2.matrix[ri][rj]
+        position = {var: index for index, var in enumerate(r2.variables)}
+        index_map = [(index, position[var])
+                     for index, var in enumerate(extended_vars)
+                     if var in position]
+
+        # fill the resized matrix with values from original matrix;
+        # read the matrix property once, it is not a plain attribute
+        source = r2.matrix
+        for mi, ri in index_map:
+            row, source_row = matrix2[mi], source[ri]
+            for mj, rj in index_map:
+                row[mj] = source_row[rj]
 
         return Relation(extended_vars, matrix1), Relation(extended_vars,
                                                           matrix2)
 
-    def eval(self, choices: List[int], index: int):
-        """Eval experiment: returns a choice object."""
+    @timed('eval')
+    def eval(self, choices: List[int], index: int,
+             store: Optional[InfinityStore] = None) -> Choices:
+        """Evaluate relation: find the choices that do not lead to infinity.
+
+        Arguments:
+            choices: list of valid choices for one index, e.g. [0,1,2]
+            index: the length of the vector, e.g. 10
+            store: choices already known to lead to infinity
+
+        Returns:
+            Choice object whose vectors are disjoint.
+        """
+        diagram = self.choice_diagram(choices, index, store)
+        if logger.isEnabledFor(logging.DEBUG):
+            logger.debug('valid choice sequences: %d', diagram.count())
+        return Choices(diagram.vectors)
+
+    @property
+    def infinity(self) -> int:
+        """Decision diagram of the choices for which some polynomial of
+        the matrix is infinite.
 
-        infinity_deltas = set()
+        Polynomials keep their infinite monomials indexed, so this takes
+        time proportional to their number, plus one check per cell.
+        """
+        scalars = self.scalars
+        if scalars is not None:
+            return I if scalars.infinite else BOT
+        return infinity_of(poly for row in self.matrix for poly in row)
 
-        # get all choices leading to infinity
-        for row in self.matrix:
-            for poly in row:
-                infinity_deltas.update(poly.eval)
+    def hopeless(self, store: Optional[InfinityStore] = None) -> bool:
+        """Check if every choice already leads to infinity.
 
-        # generate valid choices
-        return Choices.generate(choices, index, infinity_deltas)
+        Arguments:
+            store: choices known to lead to infinity elsewhere
+
+        Returns:
+            True if no choice can give a valid derivation.
+        """
+        scalars = self.scalars
+        if scalars is not None:
+            return scalars.infinite or (store is not None and store.node == I)
+        return infinity_of((poly for row in self.matrix for poly in row),
+                           store.node if store else BOT) == I
+
+    def choice_diagram(self, choices: List[int], index: int,
+                       store: Optional[InfinityStore] = None) \
+            -> ChoiceDiagram:
+        """Combine the infinity conditions of all polynomials into one
+        decision diagram of valid choices, which supports counting and
+        sampling them.
+
+        Arguments:
+            choices: list of valid choices for one index, e.g. [0,1,2]
+            index: the length of the vector, e.g. 10
+            store: choices already known to lead to infinity; the
+                evaluation starts from this region
+
+        Returns:
+            Valid choices as a decision diagram.
+        """
+        return ChoiceDiagram.of_polynomials(
+            choices, index, (poly for row in self.matrix for poly in row),
+            store.node if store else BOT)
@@ -3,8 +3,10 @@
 from __future__ import annotations
 from typing import List, Optional
 
+from .blocks import BlockRelation
 from .relation import Relation
-from .delta_graphs import DeltaGraph
+from .infinity import InfinityStore
+from .stats import timed
 
 
 class RelationList:
@@ -147,6 +149,7 @@ class RelationList:
         self.relations = [rel.replace_column(vector, variable)
                           for rel in self.relations]
 
+    @timed('composition', observe=True)
     def composition(self, other: RelationList) -> None:
         """Apply composition to all relations in two relation lists.
 
@@ -155,7 +158,9 @@ class RelationList:
         relation, for all combinations.
 
         Composition occurs in place. After composition `self` will contain all
-        unique relations obtained during composition.
+        unique relations obtained during composition. Block relations are
+        compared [block by block](blocks.md#pymwp.blocks.BlockRelation
+        .equal), and a single product is not compared at all.
 
         To compose `RelationList` and a single `Relation`, see
         [`one_composition()`](relation_list.md#pymwp.relation_list.
@@ -164,15 +169,41 @@ class RelationList:
         Arguments:
             other: RelationList to compose with `self`
         """
+        if len(self.relations) == 1 and len(other.relations) == 1:
+            self.relations = [self.first * other.first]
+            return
+
         new_list = []
         for r1 in self.relations:
             for r2 in other.relations:
                 output = r1 * r2
-                if not RelationList.contains_matrix(new_list, output.matrix):
+                if not RelationList.contains_relation(new_list, output):
                     new_list.append(output)
 
         self.relations = new_list
 
+    @staticmethod
+    def contains_relation(search_in: List, relation) -> bool:
+        """Check if a list of relations contains a relation equal to the
+        provided one.
+
+        [Block relations](blocks.md#pymwp.blocks.BlockRelation) are
+        compared by their blocks; other relations by their matrix, see
+        [`contains_matrix()`](relation_list.md#pymwp.relation_list
+        .RelationList.contains_matrix).
+
+        Arguments:
+            search_in: list of relations to search
+            relation: search value to look for
+
+        Returns:
+            `True` if relation is found somewhere in the list of relations
+                and `False` otherwise.
+        """
+        if isinstance(relation, BlockRelation):
+            return any(relation.equal(other) for other in search_in)
+        return RelationList.contains_matrix(search_in, relation.matrix)
+
     @staticmethod
     def contains_matrix(search_in: List[Relation], matrix: List[List]) -> bool:
         """Check if a list of relations contains the provided matrix.
@@ -202,6 +233,7 @@ class RelationList:
         """
         self.relations = [rel * relation for rel in self.relations]
 
+    @timed('fixpoint', observe=True)
     def fixpoint(self) -> None:
         """Apply [fixpoint](relation.md#pymwp.relation.Relation.fixpoint)
          to all relations in relation list."""
@@ -211,8 +243,9 @@ class RelationList:
         """Display relation list."""
         print(str(self))
 
-    def while_correction(self, dg: DeltaGraph) -> None:
+    @timed('while_correction')
+    def while_correction(self, store: InfinityStore) -> None:
         """Apply [`while_correction()`](relation.md#pymwp.relation.Relation
         .while_correction) to all relations in a relation list."""
         for rel in self.relations:
-            rel.while_correction(dg)
+            rel.while_correction(store)
@@ -0,0 +1,202 @@
+# flake8: noqa: W605
+
+"""
+Dense matrices of scalars.
+
+Many relations carry only plain scalars: assignments of a variable or a
+constant, unary operations, and loops whose bodies only contain such
+statements have no deltas. [`ScalarMatrix`](scalars.md#pymwp.scalars
+.ScalarMatrix) stores such a matrix as one byte per entry, scalars being
+numbered $0, m, w, p, \\infty$ = 0..4, so that their sum is the larger
+number. Operations compute whole rows at once:
+
+- a scalar times a row is a lookup table applied with `bytes.translate`;
+- the sum of two rows, the larger byte at each position, is computed on
+  the rows read as one large integer, with a borrow-free comparison of
+  all bytes at once.
+
+When the [native kernels](native.md) are available, products and sums use
+their branch-free loops instead. A [`Relation`](relation.md) switches to
+this representation on its own when none of its polynomials has deltas,
+see [`Relation.scalars`](relation.md#pymwp.relation.Relation.scalars),
+and creates polynomials again only when its matrix is read.
+"""
+
+from __future__ import annotations
+
+from typing import List, Optional, Tuple
+
+from . import backend, native
+from .semiring import KEYS, prod_mwp
+from .stats import span
+
+O, M, W, P, I = range(5)
+"""Scalars, numbered by their position in `semiring.KEYS`."""
+
+CODE = {scalar: n for n, scalar in enumerate(KEYS)}
+"""Number of each scalar."""
+
+PROD = [bytes(CODE[prod_mwp(KEYS[a], KEYS[b])] if b < 5 else 0
+              for b in range(256)) for a in range(5)]
+"""Table of `bytes.translate` for the product by each scalar."""
+
+CORRECT = [bytes(I if b == p else b for b in range(256)) for p in (W, P)]
+"""Tables that replace $w$, then $p$, by $\\infty$."""
+
+
+def _high(size: int) -> int:
+    """Integer whose `size` bytes have their high bit set."""
+    return int.from_bytes(b'\x80' * size, 'little')
+
+
+def row_max(a: bytes, b: bytes) -> bytes:
+    """Larger byte at each position of two rows of scalars."""
+    size = len(a)
+    x, y = int.from_bytes(a, 'little'), int.from_bytes(b, 'little')
+    high = _high(size)
+    # high bit of each byte of ((x | high) - y) is set where x >= y
+    mask = ((((x | high) - y) & high) >> 7) * 0xFF
+    return ((x & mask) | (y & ~mask)).to_bytes(size, 'little')
+
+
+class ScalarMatrix:
+    """Square matrix of scalars, stored by rows as bytes."""
+
+    __slots__ = ['size', 'data']
+
+    def __init__(self, size: int, data: bytes):
+        """Create matrix.
+
+        Arguments:
+            size: number of rows and columns
+            data: `size * size` scalar numbers, by rows
+        """
+        self.size = size
+        self.data = bytes(data)
+
+    def __eq__(self, other):
+        if isinstance(other, ScalarMatrix):
+            return self.data == other.data
+        return NotImplemented
+
+    def __add__(self, other):
+        return self.sum(other)
+
+    def __mul__(self, other):
+        return self.prod(other)
+
+    @staticmethod
+    def of(matrix: List[List]) -> Optional[ScalarMatrix]:
+        """Matrix of the scalars of polynomials without deltas.
+
+        Arguments:
+            matrix: matrix of polynomials of either backend
+
+        Returns:
+            Scalar matrix, or `None` if some polynomial has deltas.
+        """
+        data = bytearray()
+        for row in matrix:
+            for poly in row:
+                scalar = poly.constant
+                if scalar is None:
+                    return None
+                data.append(CODE[scalar])
+        return ScalarMatrix(len(matrix), data)
+
+    @staticmethod
+    def identity(size: int) -> ScalarMatrix:
+        """Identity matrix of `size` rows."""
+        data = bytearray(size * size)
+        data[::size + 1] = bytes([M]) * size
+        return ScalarMatrix(size, data)
+
+    def polynomials(self) -> List[List]:
+        """Matrix of constant polynomials of the selected backend.
+
+        Entries with the same scalar share one
+        [constant polynomial](backend.md#pymwp.backend.constant).
+        """
+        constants = [backend.constant(key) for key in KEYS]
+        n, data = self.size, self.data
+        return [[constants[c] for c in data[i * n:(i + 1) * n]]
+                for i in range(n)]
+
+    def embed(self, index: List[int]) -> ScalarMatrix:
+        """View matrix over other variables, identity where it is not
+        defined.
+
+        Arguments:
+            index: row and column of `self` at each position of the
+                result, or -1 where the result is identity, see
+                [`extend`](matrix.md#pymwp.matrix.extend)
+
+        Returns:
+            Matrix of size `len(index)`.
+        """
+        if index == list(range(self.size)):
+            return self
+        result = ScalarMatrix.identity(len(index))
+        data, n = bytearray(result.data), self.size
+        for a, i in enumerate(index):
+            if i >= 0:
+                row = self.data[i * n:(i + 1) * n]
+                for b, j in enumerate(index):
+                    if j >= 0:
+                        data[a * len(index) + b] = row[j]
+        return ScalarMatrix(len(index), data)
+
+    def sum(self, other: ScalarMatrix) -> ScalarMatrix:
+        """Sum of matrices of the same size."""
+        kernel = native.kernel()
+        if kernel is not None:
+            return ScalarMatrix(self.size,
+                                kernel.scalar_sum(self.data, other.data))
+        return ScalarMatrix(self.size, row_max(self.data, other.data))
+
+    def prod(self, other: ScalarMatrix) -> ScalarMatrix:
+        """Product of matrices of the same size."""
+        n = self.size
+        kernel = native.kernel()
+        if kernel is not None:
+            return ScalarMatrix(
+                n, kernel.scalar_prod(self.data, other.data, n))
+        rows = [other.data[k * n:(k + 1) * n] for k in range(n)]
+        data = bytearray()
+        for i in range(n):
+            total = bytes(n)
+            for k, a in enumerate(self.data[i * n:(i + 1) * n]):
+                total = row_max(total, rows[k].translate(PROD[a]))
+            data += total
+        return ScalarMatrix(n, data)
+
+    def closure(self) -> ScalarMatrix:
+        """Sum of all powers of the matrix, as
+        [`Relation.iterated_fixpoint`](relation.md#pymwp.relation
+        .Relation.iterated_fixpoint)."""
+        fix = current = ScalarMatrix.identity(self.size)
+        iteration = 0
+        while True:
+            with span('fixpoint_iteration', iteration=iteration,
+                      matrix_size=self.size):
+                current = current * self
+                total = fix + current
+                if total == fix:
+                    return total
+                fix = total
+            iteration += 1
+
+    def while_correction(self) -> Tuple[ScalarMatrix, bool]:
+        """Replace $p$, and $w$ on the diagonal, by $\\infty$.
+
+        Returns:
+            Corrected matrix, and whether some entry became $\\infty$.
+        """
+        data = bytearray(self.data.translate(CORRECT[1]))
+        data[::self.size + 1] = data[::self.size + 1].translate(CORRECT[0])
+        return ScalarMatrix(self.size, data), data != self.data
+
+    @property
+    def infinite(self) -> bool:
+        """Some entry is $\\infty$."""
+        return I in self.data
@@ -0,0 +1,317 @@
+"""
+Long-running analysis server.
+
+Starting pymwp for every analyzed file pays for interpreter startup,
+imports and construction of the C parser each time. The server keeps one
+warm process that answers analysis requests, and remembers results of
+sources it has already analyzed.
+
+Requests and responses are [JSON-RPC 2.0](https://www.jsonrpc.org/specification)
+objects, one per line. The server reads them either from standard input
+(responses go to standard output) or from clients connecting to a Unix
+domain socket.
+
+Supported methods:
+
+- `analyze`: analyze a C file or source code. Parameters:
+
+    - `file` (`str`): path to C file, -or-
+    - `code` (`str`): C source code
+    - `no_eval` (`bool`, optional): skip evaluation phase
+    - `no_cpp` (`bool`, optional): do not run C pre-processor
+
+    Functions are analyzed as by [`Analysis.run`](analysis.md#pymwp
+    .analysis.Analysis.run), callees first, and calls use the summaries
+    of called functions. The result has the same structure as the file
+    written by [`save_relation`](file_io.md#pymwp.file_io.save_relation).
+
+- `clear_cache`: forget all cached results.
+
+- `shutdown`: stop the server after responding.
+
+Example:
+
+```text
+$ pymwp serve
+{"jsonrpc": "2.0", "id": 1, "method": "analyze", "params": {"file": "c_files/basics/if.c"}}
+{"jsonrpc": "2.0", "id": 1, "result": {"foo": {"relation": ..., "choices": [[[0, 1, 2]]], "infinity": false}}}
+```
+"""  # noqa: E501
+
+import hashlib
+import json
+import logging
+import os
+import socketserver
+import stat
+import sys
+from subprocess import CalledProcessError, check_output
+from typing import Optional, TextIO
+
+from pycparser import c_parser, preprocess_file
+from pycparser.plyparser import ParseError
+
+from .analysis import Analysis
+from .calls import CallGraph
+from .file_io import encode_result, is_analyzable
+from .mdd import MANAGER
+
+logger = logging.getLogger(__name__)
+
+PARSE_ERROR = -32700
+"""JSON-RPC error code: request is not valid JSON."""
+
+INVALID_REQUEST = -32600
+"""JSON-RPC error code: request is not a valid request object."""
+
+METHOD_NOT_FOUND = -32601
+"""JSON-RPC error code: requested method does not exist."""
+
+INVALID_PARAMS = -32602
+"""JSON-RPC error code: invalid method parameters."""
+
+ANALYSIS_ERROR = -32000
+"""JSON-RPC error code: input could not be parsed or analyzed."""
+
+ANALYZE_PARAMS = {'file', 'code', 'no_eval', 'no_cpp'}
+"""Parameters accepted by `analyze` method."""
+
+
+class RequestError(Exception):
+    """Error that is reported to the client as JSON-RPC error."""
+
+    def __init__(self, code: int, message: str):
+        super().__init__(message)
+        self.code = code
+
+
+class Server:
+    """Analysis server that keeps parser and results in memory."""
+
+    def __init__(self, cpp_path: str = 'gcc', cpp_args: str = '-E',
+                 use_cpp: bool = True):
+        """Create analysis server.
+
+        Arguments:
+            cpp_path: path to C pre-processor
+            cpp_args: arguments to pass to C pre-processor
+            use_cpp: run C pre-processor on inputs, unless request says
+                otherwise
+        """
+        self.cpp_path = cpp_path
+        self.cpp_args = cpp_args
+        self.use_cpp = use_cpp
+        self.parser = c_parser.CParser()
+        self.cache = {}
+        self.running = True
+
+    def handle_line(self, line: str) -> Optional[str]:
+        """Handle one line of input.
+
+        Arguments:
+            line: JSON-RPC request
+
+        Returns:
+            JSON-RPC response, or `None` if request was a notification.
+        """
+        try:
+            request = json.loads(line)
+        except ValueError as e:
+            return json.dumps(Server.error(None, PARSE_ERROR, str(e)))
+        response = self.handle(request)
+        return json.dumps(response) if response is not None else None
+
+    def handle(self, request: dict) -> Optional[dict]:
+        """Dispatch a JSON-RPC request to the matching method.
+
+        Arguments:
+            request: decoded JSON-RPC request
+
+        Returns:
+            Response object, or `None` if request was a notification.
+        """
+        request_id = request.get('id') if isinstance(request, dict) \
+            else None
+        try:
+            if not isinstance(request, dict) or \
+                    not isinstance(request.get('method'), str):
+                raise RequestError(INVALID_REQUEST, 'invalid request')
+            params = request.get('params') or {}
+            if not isinstance(params, dict):
+                raise RequestError(INVALID_PARAMS, 'params must be object')
+            method = request['method']
+            if method == 'analyze':
+                unknown = set(params) - ANALYZE_PARAMS
+                if unknown:
+                    raise RequestError(
+                        INVALID_PARAMS, f'unknown params: {sorted(unknown)}')
+                result = self.analyze(**params)
+            elif method == 'clear_cache':
+                self.cache.clear()
+                result = True
+            elif method == 'shutdown':
+                self.running = False
+                result = True
+            else:
+                raise RequestError(
+                    METHOD_NOT_FOUND, f'unknown method: {method}')
+        except RequestError as e:
+            return Server.error(request_id, e.code, str(e))
+        except Exception as e:  # keep serving after unexpected failures
+            logger.exception('request failed')
+            return Server.error(request_id, ANALYSIS_ERROR, repr(e))
+        if 'id' not in request:
+            return None
+        return {'jsonrpc': '2.0', 'id': request_id, 'result': result}
+
+    @staticmethod
+    def error(request_id, code: int, message: str) -> dict:
+        """Build JSON-RPC error response."""
+        return {'jsonrpc': '2.0', 'id': request_id,
+                'error': {'code': code, 'message': message}}
+
+    def analyze(self, file: Optional[str] = None, code: Optional[str] = None,
+                no_eval: bool = False, no_cpp: bool = False) -> dict:
+        """Analyze C file or source code.
+
+        Results are cached by source text and options. Files included by
+        the pre-processor are not part of the cache key.
+
+        Arguments:
+            file: path to C file
+            code: C source code
+            no_eval: skip evaluation phase
+            no_cpp: do not run C pre-processor
+
+        Raises:
+            RequestError: if input is missing, cannot be read or is not
+                analyzable.
+
+        Returns:
+            Dictionary of encoded results by function name.
+        """
+        if (file is None) == (code is None):
+            raise RequestError(
+                INVALID_PARAMS, 'specify exactly one of: file, code')
+        use_cpp = self.use_cpp and not no_cpp
+        if file is not None:
+            try:
+                with open(file) as source:
+                    code = source.read()
+            except OSError as e:
+                raise RequestError(ANALYSIS_ERROR, str(e))
+
+        key = hashlib.sha256('\0'.join(
+            [code, str(use_cpp), str(no_eval),
+             os.path.abspath(file) if file else '']).encode()).hexdigest()
+        if key in self.cache:
+            logger.debug('cache hit for %s', file or 'code')
+            return self.cache[key]
+
+        graph = CallGraph(list(self.parse(code, file, use_cpp)))
+        mark = MANAGER.mark()
+        try:
+            results = dict(Analysis.analyze_program(graph, no_eval))
+            result = {name: encode_result(results[name])
+                      for name in graph.functions}
+        finally:
+            # results are encoded; no decision diagram is needed anymore
+            MANAGER.release(mark)
+        self.cache[key] = result
+        return result
+
+    def parse(self, code: str, file: Optional[str], use_cpp: bool):
+        """Pre-process and parse C source using the server's parser.
+
+        Arguments:
+            code: C source code
+            file: path of the source, if it was read from file
+            use_cpp: run C pre-processor
+
+        Raises:
+            RequestError: if source cannot be parsed or is not analyzable.
+
+        Returns:
+            Parsed AST.
+        """
+        try:
+            if use_cpp and file is not None:
+                code = preprocess_file(file, self.cpp_path, self.cpp_args)
+            elif use_cpp:
+                code = check_output(
+                    [self.cpp_path, self.cpp_args, '-'], input=code,
+                    universal_newlines=True)
+            ast = self.parser.parse(code, file or '<code>')
+        except (CalledProcessError, RuntimeError, OSError,
+                ParseError) as e:
+            raise RequestError(ANALYSIS_ERROR, f'failed to parse: {e}')
+        if not is_analyzable(ast):
+            raise RequestError(
+                ANALYSIS_ERROR, 'input C code is invalid or empty')
+        return ast
+
+    def serve_stream(self, in_stream: TextIO, out_stream: TextIO) -> None:
+        """Answer requests read line by line from a stream.
+
+        Serving stops at end of input or after `shutdown` request.
+
+        Arguments:
+            in_stream: stream of requests
+            out_stream: stream where responses are written
+        """
+        for line in iter(in_stream.readline, ''):
+            if not line.strip():
+                continue
+            response = self.handle_line(line)
+            if response is not None:
+                out_stream.write(response + '\n')
+                out_stream.flush()
+            if not self.running:
+                break
+
+    def serve_socket(self, path: str) -> None:
+        """Answer requests from clients connecting to a Unix domain socket.
+
+        Clients are served one at a time. Serving stops after `shutdown`
+        request; the socket file is removed on exit.
+
+        Arguments:
+            path: socket file path
+
+        Raises:
+            FileExistsError: if path exists and is not a socket.
+        """
+        server = self
+
+        class Handler(socketserver.StreamRequestHandler):
+            def handle(self):
+                for line in self.rfile:
+                    if not line.strip():
+                        continue
+                    response = server.handle_line(line.decode())
+                    if response is not None:
+                        self.wfile.write((response + '\n').encode())
+                        self.wfile.flush()
+                    if not server.running:
+                        break
+
+        if os.path.exists(path):
+            # only a stale socket of an earlier server is replaced
+            if not stat.S_ISSOCK(os.stat(path).st_mode):
+                raise FileExistsError(f'not a socket: {path}')
+            os.remove(path)
+        with socketserver.UnixStreamServer(path, Handler) as unix_server:
+            logger.info('listening on %s', path)
+            try:
+                while self.running:
+                    unix_server.handle_request()
+            finally:
+                os.remove(path)
+
+    def serve(self, socket_path: Optional[str] = None) -> None:
+        """Start serving on socket if path is given, otherwise on standard
+        input and output."""
+        if socket_path:
+            self.serve_socket(socket_path)
+        else:
+            self.serve_stream(sys.stdin, sys.stdout)
@@ -0,0 +1,240 @@
+"""
+Instrumentation of analysis phases.
+
+Analysis phases are marked with [`timed`](stats.md#pymwp.stats.timed)
+decorator or [`span`](stats.md#pymwp.stats.span) context manager. When no
+collector is active, marking a phase costs only one check of an empty list.
+
+A collector receives notifications when marked phases begin and end.
+[`Stats`](stats.md#pymwp.stats.Stats) is a collector that records wall time
+and number of calls of each phase, for each analyzed function.
+
+Example:
+
+```python
+with Stats() as stats:
+    ast = parse('c_files/basics/if.c')
+    Analysis.run(ast, no_save=True)
+stats.save('output/if.stats.json')
+```
+"""
+
+from __future__ import annotations
+
+import json
+import os
+import time
+from contextlib import contextmanager
+from functools import wraps
+from typing import Any, Callable, Dict, Iterator, List, Optional
+
+COLLECTORS: List[Collector] = []
+"""Currently active collectors."""
+
+FUNCTION = 'function'
+"""Name of phase that spans analysis of one function."""
+
+
+class Collector:
+    """Receives notifications of analysis phases.
+
+    Collector is active while used as a context manager, or between calls
+    to `start()` and `stop()`.
+    """
+
+    def begin(self, name: str, args: Dict[str, Any]) -> None:
+        """Phase `name` begins."""
+
+    def end(self, name: str, args: Dict[str, Any]) -> None:
+        """Phase `name` ends."""
+
+    def observe(self, name: str, relations: Any) -> None:
+        """Relation list produced by phase `name`."""
+
+    @property
+    def active(self) -> bool:
+        return self in COLLECTORS
+
+    def start(self) -> None:
+        """Start receiving notifications."""
+        if not self.active:
+            COLLECTORS.append(self)
+
+    def stop(self) -> None:
+        """Stop receiving notifications."""
+        if self.active:
+            COLLECTORS.remove(self)
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *_):
+        self.stop()
+
+
+def begin(phase: str, **args) -> None:
+    """Notify active collectors that `phase` begins."""
+    for collector in COLLECTORS:
+        collector.begin(phase, args)
+
+
+def end(phase: str, **args) -> None:
+    """Notify active collectors that `phase` ends."""
+    for collector in COLLECTORS:
+        collector.end(phase, args)
+
+
+@contextmanager
+def span(phase: str, **args) -> Iterator[None]:
+    """Mark a block of code as `phase`.
+
+    Arguments:
+        phase: phase name
+        **args: details of the phase, e.g. function name
+    """
+    if not COLLECTORS:
+        yield
+        return
+    begin(phase, **args)
+    try:
+        yield
+    finally:
+        end(phase, **args)
+
+
+def timed(name: str, observe: bool = False) -> Callable:
+    """Decorator that marks every call of a function as phase `name`.
+
+    Arguments:
+        name: phase name
+        observe: after the call, pass the first argument of the decorated
+            function (a relation list) to collectors for inspection.
+    """
+
+    def decorator(func: Callable) -> Callable:
+        @wraps(func)
+        def wrapper(*args, **kwargs):
+            if not COLLECTORS:
+                return func(*args, **kwargs)
+            begin(name)
+            try:
+                result = func(*args, **kwargs)
+            finally:
+                end(name)
+            if observe:
+                for collector in COLLECTORS:
+                    collector.observe(name, args[0])
+            return result
+
+        return wrapper
+
+    return decorator
+
+
+class Stats(Collector):
+    """Records wall time and call count of each phase, per function.
+
+    Phases that occur outside of analysis of a function, such as parsing
+    and saving the result, are recorded at file level. When phases are
+    nested, e.g. recursive calls of `compute_relation`, every call is
+    counted but time is measured only once, on the outermost call.
+
+    In addition, for each function, it records:
+
+    - `peak_relations`: largest number of relations in a relation list
+    - `max_polynomial`: largest number of monomials in one polynomial
+    - `matrix_size`: largest matrix dimension
+    """
+
+    def __init__(self):
+        self.phases = {}
+        self.functions = {}
+        self.current: Optional[dict] = None
+        self.started = {}
+        self.depth = {}
+
+    @staticmethod
+    def new_function() -> dict:
+        return {'time': 0, 'phases': {}, 'peak_relations': 0,
+                'max_polynomial': 0, 'matrix_size': 0}
+
+    @property
+    def target(self) -> dict:
+        """Phase record of current function, or file if none."""
+        return self.current['phases'] if self.current else self.phases
+
+    def begin(self, name: str, args: Dict[str, Any]) -> None:
+        if name == FUNCTION:
+            self.current = self.functions.setdefault(
+                args['name'], Stats.new_function())
+            self.started[name] = time.perf_counter()
+            return
+        phase = self.target.setdefault(name, {'time': 0, 'calls': 0})
+        phase['calls'] += 1
+        self.depth[name] = self.depth.get(name, 0) + 1
+        if self.depth[name] == 1:
+            self.started[name] = time.perf_counter()
+
+    def end(self, name: str, args: Dict[str, Any]) -> None:
+        elapsed = time.perf_counter() - self.started.get(name, 0)
+        if name == FUNCTION:
+            if self.current:
+                self.current['time'] += elapsed
+            self.current = None
+            return
+        self.depth[name] -= 1
+        if self.depth[name] == 0:
+            self.target[name]['time'] += elapsed
+
+    def observe(self, name: str, relations: Any) -> None:
+        if self.current is None:
+            return
+        current = self.current
+        current['peak_relations'] = max(
+            current['peak_relations'], len(relations.relations))
+        for relation in relations.relations:
+            current['matrix_size'] = max(
+                current['matrix_size'], len(relation.variables))
+            # block relations assemble their matrix on demand, so only
+            # their blocks are read
+            for part in getattr(relation, 'blocks', [relation]):
+                if part.scalars is not None:
+                    # one monomial per polynomial
+                    current['max_polynomial'] = max(
+                        current['max_polynomial'], 1)
+                    continue
+                for row in part.matrix:
+                    for poly in row:
+                        current['max_polynomial'] = max(
+                            current['max_polynomial'], len(poly.list))
+
+    def to_dict(self) -> dict:
+        """Get dictionary representation of recorded statistics."""
+        return {'phases': self.phases, 'functions': self.functions}
+
+    def show(self) -> None:
+        """Print recorded statistics as JSON."""
+        print(json.dumps(self.to_dict(), indent=4))
+
+    @staticmethod
+    def file_name(file_out: str) -> str:
+        """Generate statistics filename that sits next to result file,
+        e.g. `output/foo.json` gives `output/foo.stats.json`.
+
+        Arguments:
+            file_out: analysis result filename
+
+        Returns:
+            Statistics filename.
+        """
+        return os.path.splitext(file_out)[0] + '.stats.json'
+
+    def save(self, file_name: str) -> None:
+        """Write recorded statistics to file as JSON.
+
+        Arguments:
+            file_name: filename where to write
+        """
+        with open(file_name, 'w') as outfile:
+            json.dump(self.to_dict(), outfile, indent=4)
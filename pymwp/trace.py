@@ -0,0 +1,78 @@
+"""
+Timeline of analysis execution in Chrome trace-event format.
+
+[`Trace`](trace.md#pymwp.trace.Trace) is a
+[collector](stats.md#pymwp.stats.Collector) that records every analysis
+phase as a nested span. The saved file loads in a local trace viewer, such
+as [Perfetto](https://ui.perfetto.dev) or `chrome://tracing`.
+
+Recorded spans include each function, each top-level statement, each
+`while` and `for` loop, each fixpoint iteration and each relation list
+composition. Composition and fixpoint spans carry the number of
+relations and matrix size as arguments.
+
+Example:
+
+```python
+with Trace() as trace:
+    Analysis.run(ast, no_save=True)
+trace.save('trace.json')
+```
+"""
+
+import json
+import os
+import time
+from typing import Any, Dict, List
+
+from .stats import Collector
+
+
+class Trace(Collector):
+    """Records analysis phases as trace events."""
+
+    def __init__(self):
+        self.events: List[dict] = []
+        self.origin = time.perf_counter()
+        self.pid = os.getpid()
+
+    def event(self, name: str, ph: str, args: Dict[str, Any]) -> None:
+        """Record one trace event.
+
+        Arguments:
+            name: span name
+            ph: event type, `B` for begin or `E` for end
+            args: span arguments
+        """
+        self.events.append({
+            'name': name, 'ph': ph, 'pid': self.pid, 'tid': 0,
+            'ts': (time.perf_counter() - self.origin) * 1e6,
+            'args': dict(args)})
+
+    def begin(self, name: str, args: Dict[str, Any]) -> None:
+        self.event(args.get('name', name), 'B', args)
+
+    def end(self, name: str, args: Dict[str, Any]) -> None:
+        self.event(args.get('name', name), 'E', {})
+
+    def observe(self, name: str, relations: Any) -> None:
+        # called right after end of the phase: annotate its end event
+        last = self.events[-1] if self.events else None
+        if last and last['ph'] == 'E' and last['name'] == name:
+            last['args'] = {
+                'relations': len(relations.relations),
+                'matrix_size': max([len(r.variables) for r in
+                                    relations.relations] or [0])}
+
+    def to_dict(self) -> dict:
+        """Get trace-event JSON object."""
+        return {'traceEvents': self.events, 'displayTimeUnit': 'ms'}
+
+    def save(self, file_name: str) -> None:
+        """Write trace to file.
+
+        Arguments:
+            file_name: filename where to write
+        """
+        with open(file_name, 'w') as outfile:
+            json.dump(self.to_dict(), outfile)
@@ -0,0 +1,87 @@
+"""
+Function-wide table of variables.
+
+The analysis knows all variables of a function before it analyzes its
+statements. [`VariableTable`](variables.md#pymwp.variables.VariableTable)
+numbers them once, and relations created while a table is active share it:
+they keep only the variables their statement involves, and variables
+missing from a relation are implicitly mapped by identity. Composition and
+sum of two such relations find matching rows and columns by variable
+number and skip the identity part, instead of first
+[homogenising](relation.md#pymwp.relation.Relation.homogenisation) both
+relations to the same variables.
+
+Example:
+
+```python
+with VariableTable(['X0', 'X1', 'X2']):
+    r1 = Relation.identity(['X0', 'X1', 'X2'])
+    r2 = Relation.identity(['X1'])
+    r3 = r1 * r2  # r2 is not resized
+```
+"""
+
+from __future__ import annotations
+
+from typing import Dict, List, Optional
+
+
+class VariableTable:
+    """Integer index of the variables of one function."""
+
+    current: Optional[VariableTable] = None
+    """Table that new relations share; `None` when no table is active."""
+
+    def __init__(self, names: Optional[List[str]] = None):
+        """Create variable table.
+
+        Arguments:
+            names: initial variables, numbered in this order
+        """
+        self.names: List[str] = []
+        self.ids: Dict[str, int] = {}
+        self.previous: Optional[VariableTable] = None
+        for name in names or []:
+            self.id(name)
+
+    def __len__(self):
+        return len(self.names)
+
+    def id(self, name: str) -> int:
+        """Get number of variable; unknown variables are added."""
+        index = self.ids.get(name)
+        if index is None:
+            index = self.ids[name] = len(self.names)
+            self.names.append(name)
+        return index
+
+    def positions(self, *variables: List[str]) -> List[List[int]]:
+        """Map variable numbers to positions in each list of variables.
+
+        Arguments:
+            variables: lists of variable names; unknown names are added
+                to the table
+
+        Returns:
+            For each list, a list whose item at a variable number is the
+            position of that variable in the list, or -1 if the variable
+            is not in the list.
+        """
+        numbers = [[self.id(name) for name in names] for names in variables]
+        result = []
+        for ids in numbers:
+            positions = [-1] * len(self.names)
+            for position, index in enumerate(ids):
+                positions[index] = position
+            result.append(positions)
+        return result
+
+    def __enter__(self) -> VariableTable:
+        """Make new relations share this table."""
+        self.previous = VariableTable.current
+        VariableTable.current = self
+        return self
+
+    def __exit__(self, *_) -> None:
+        VariableTable.current = self.previous
+        self.previous = None
@@ -0,0 +1,219 @@
+"""
+Worker processes shared by parallel computations.
+
+The number of worker processes is set once, e.g. with command line
+argument `--jobs 4`, or:
+
+```python
+workers.use(4)
+```
+
+With more than one job, products of large matrices are computed by rows,
+see [`map_rows`](workers.md#pymwp.workers.map_rows): the operands are
+placed once in shared memory, each worker computes a contiguous range of
+output rows, and rows are gathered back in order. Polynomials are
+exchanged in a packed encoding of unsigned integers: for each monomial,
+its scalar, number of deltas, and deltas.
+"""
+
+import atexit
+from array import array
+from concurrent.futures import ProcessPoolExecutor
+from multiprocessing import resource_tracker, shared_memory
+from typing import Any, Callable, List, Optional
+
+from . import backend
+from .monomial import Monomial
+
+SCALARS = 'omwpi'
+"""Scalars, numbered by their position."""
+
+NONE = 0xFFFFFFFF
+"""Length that marks a missing matrix entry."""
+
+MIN_ROWS = 48
+"""Least number of rows of a product computed by rows in parallel."""
+
+_jobs = 1
+_pool: Optional[ProcessPoolExecutor] = None
+
+
+def use(jobs: int) -> None:
+    """Set number of worker processes; 1 computes sequentially.
+
+    Raises:
+        ValueError: if number of jobs is not positive.
+    """
+    global _jobs
+    if jobs < 1:
+        raise ValueError(f'number of jobs must be positive: {jobs}')
+    if jobs != _jobs:
+        shutdown()
+    _jobs = jobs
+
+
+def jobs() -> int:
+    """Get number of worker processes."""
+    return _jobs
+
+
+def pool() -> ProcessPoolExecutor:
+    """Get pool of worker processes, started on first use."""
+    global _pool
+    if _pool is None:
+        # workers that attach to shared memory register it with the
+        # resource tracker; they must share the tracker of this process,
+        # which unlinks the memory, or each worker would start its own
+        # and report the memory as leaked at exit
+        resource_tracker.ensure_running()
+        _pool = ProcessPoolExecutor(max_workers=_jobs, initializer=_worker)
+    return _pool
+
+
+def _worker() -> None:
+    """Set up worker process: its computations are not split again."""
+    global _jobs, _pool
+    _jobs, _pool = 1, None
+
+
+@atexit.register
+def shutdown() -> None:
+    """Stop worker processes."""
+    global _pool
+    if _pool is not None:
+        _pool.shutdown()
+        _pool = None
+
+
+def pack_polynomial(poly: Any, values: array) -> None:
+    """Append packed encoding of a polynomial to `values`."""
+    for mono in poly.list:
+        values.append(SCALARS.index(mono.scalar))
+        values.append(len(mono.deltas))
+        for choice, index in mono.deltas:
+            values.append(choice)
+            values.append(index)
+
+
+def unpack_polynomial(values: array, start: int, end: int,
+                      offset: int = 0) -> Any:
+    """Decode polynomial packed in `values[start:end]`, with the selected
+    backend; `offset` is added to the index of every delta."""
+    monomials, i = [], start
+    while i < end:
+        count = values[i + 1]
+        deltas = [(values[j], values[j + 1] + offset)
+                  for j in range(i + 2, i + 2 + 2 * count, 2)]
+        monomials.append(Monomial(SCALARS[values[i]], deltas))
+        i += 2 + 2 * count
+    return backend.polynomial(monomials)
+
+
+def pack_matrices(matrices: List[List[List[Any]]]) -> array:
+    """Pack matrices whose entries are polynomials or `None`.
+
+    Each matrix is encoded as its number of rows and columns, then, for
+    each entry, the length of its encoding followed by the encoding.
+    """
+    values = array('I', [len(matrices)])
+    for matrix in matrices:
+        values.append(len(matrix))
+        values.append(len(matrix[0]) if matrix else 0)
+        for row in matrix:
+            for poly in row:
+                if poly is None:
+                    values.append(NONE)
+                    continue
+                position = len(values)
+                values.append(0)
+                pack_polynomial(poly, values)
+                values[position] = len(values) - position - 1
+    return values
+
+
+def unpack_matrices(values: array) -> List[List[List[Any]]]:
+    """Decode matrices packed by
+    [`pack_matrices`](workers.md#pymwp.workers.pack_matrices)."""
+    matrices, i = [], 1
+    for _ in range(values[0]):
+        rows, columns = values[i], values[i + 1]
+        i += 2
+        matrix = []
+        for _ in range(rows):
+            row = []
+            for _ in range(columns):
+                length = values[i]
+                if length == NONE:
+                    row.append(None)
+                    i += 1
+                    continue
+                row.append(unpack_polynomial(values, i + 1, i + 1 + length))
+                i += 1 + length
+            matrix.append(row)
+        matrices.append(matrix)
+    return matrices
+
+
+def compute_rows(function: Callable, name: str, memory: str, length: int,
+                 rows: range) -> bytes:
+    """Compute rows of a product in a worker process.
+
+    Arguments:
+        function: computes the listed rows from the operands
+        name: polynomial backend name
+        memory: name of shared memory holding the packed operands
+        length: number of packed values
+        rows: output rows to compute
+
+    Returns:
+        Packed rows.
+    """
+    if backend.name() != name:
+        backend.use(name)
+    shared = shared_memory.SharedMemory(name=memory)
+    try:
+        values = array('I')
+        values.frombytes(bytes(shared.buf[:length * values.itemsize]))
+    finally:
+        shared.close()
+    return pack_matrices([function(*unpack_matrices(values), rows)]) \
+        .tobytes()
+
+
+def map_rows(function: Callable, operands: List[List[List[Any]]],
+             size: int) -> List[List[Any]]:
+    """Compute rows of a product in worker processes.
+
+    Arguments:
+        function: module-level function that takes the operands and a
+            range of rows, and returns these rows of the product
+        operands: matrices whose entries are polynomials or `None`
+        size: number of rows of the product
+
+    Returns:
+        All rows of the product, in order.
+    """
+    values = pack_matrices(operands)
+    data = values.tobytes()
+    shared = shared_memory.SharedMemory(create=True, size=max(len(data), 1))
+    try:
+        shared.buf[:len(data)] = data
+        step = -(-size // _jobs)
+        tasks = [pool().submit(compute_rows, function, backend.name(),
+                               shared.name, len(values),
+                               range(start, min(start + step, size)))
+                 for start in range(0, size, step)]
+        result = []
+        for task in tasks:
+            packed = array('I')
+            packed.frombytes(task.result())
+            result.extend(unpack_matrices(packed)[0])
+        return result
+    finally:
+        shared.close()
+        shared.unlink()
+
+
+def worthwhile(size: int) -> bool:
+    """Check if a product with `size` rows is computed in parallel."""
+    return _jobs > 1 and size >= MIN_ROWS
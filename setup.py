@@ -9,12 +9,22 @@ with open("README.md", "r", encoding="utf-8") as fh:
 with open(os.path.join(here, "pymwp", "version.py")) as fh:
     exec(fh.read())
 
+# optional native kernels; without a C++ compiler, pure Python is used
+native = [setuptools.Extension(
+    f"pymwp._{name}",
+    sources=[f"src/{name}.cpp"],
+    language="c++",
+    extra_compile_args=["-std=c++11", "-O2"],
+    optional=True,
+) for name in ("algebra", "choice")]
+
 setuptools.setup(
     name="pymwp",
     version=__version__,
     author="Clément Aubert, Thomas Rubiano, Neea Rusch, Thomas Seiller",
     author_email="nrusch@augusta.edu",
     packages=["pymwp"],
+    ext_modules=native,
     entry_points={
         "console_scripts": ["pymwp = pymwp.__main__:main"],
     },
@@ -0,0 +1,736 @@
+// Native kernels of the polynomial algebra of pymwp.
+//
+// This extension computes the same results as the pure-Python sum and
+// product of list polynomials (pymwp/polynomial.py), step by step, and
+// the matrix products built on them (pymwp/matrix.py). Monomials are kept
+// as a scalar in 0..4 (o, m, w, p, i) and a range of packed deltas in an
+// arena; a delta (choice, index) is packed as index * 4 + choice, so that
+// comparing packed deltas compares index first, then choice. Python
+// objects are only read at the inputs and created at the outputs.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum Scalar : uint8_t { O = 0, M = 1, W = 2, P = 3, I = 4 };
+
+inline uint8_t sum_mwp(uint8_t a, uint8_t b) { return a > b ? a : b; }
+
+inline uint8_t prod_mwp(uint8_t a, uint8_t b) {
+    if (a == I || b == I) return I;
+    if (a == O || b == O) return O;
+    return a > b ? a : b;
+}
+
+struct Mono {
+    uint8_t scalar;
+    uint32_t offset;
+    uint32_t length;
+};
+
+using Poly = std::vector<Mono>;
+
+// Deltas of all monomials of one computation.
+struct Arena {
+    std::vector<uint64_t> deltas;
+
+    const uint64_t *at(const Mono &m) const { return deltas.data() + m.offset; }
+};
+
+enum Comparison { SMALLER = -1, EQUAL = 0, LARGER = 1 };
+
+// Polynomial.compare
+Comparison compare(const Arena &arena, const Mono &a, const Mono &b) {
+    const uint64_t *da = arena.at(a), *db = arena.at(b);
+    uint32_t n = a.length < b.length ? a.length : b.length;
+    for (uint32_t k = 0; k < n; k++) {
+        if (da[k] != db[k]) return da[k] < db[k] ? SMALLER : LARGER;
+    }
+    if (a.length > b.length) return LARGER;
+    if (a.length < b.length) return SMALLER;
+    return EQUAL;
+}
+
+// Monomial.contains: all deltas of b are deltas of a
+bool contains(const Arena &arena, const Mono &a, const Mono &b) {
+    const uint64_t *da = arena.at(a), *db = arena.at(b);
+    for (uint32_t k = 0; k < b.length; k++) {
+        bool found = false;
+        for (uint32_t l = 0; l < a.length && !found; l++) found = da[l] == db[k];
+        if (!found) return false;
+    }
+    return true;
+}
+
+enum Inclusion { NONE, CONTAINS, INCLUDED };
+
+// Monomial.inclusion
+Inclusion inclusion(const Arena &arena, const Mono &self, const Mono &mono) {
+    uint8_t summ = sum_mwp(self.scalar, mono.scalar);
+    if (contains(arena, self, mono) && mono.scalar == summ) return CONTAINS;
+    if (contains(arena, mono, self) && self.scalar == summ) return INCLUDED;
+    return NONE;
+}
+
+// Polynomial.inclusion: remove monomials of list included in mono, and
+// tell whether mono is to be inserted; i is shifted with removals.
+bool include(const Arena &arena, Poly &list, const Mono &mono, size_t &i) {
+    size_t j = 0;
+    while (j < list.size()) {
+        Inclusion incl = inclusion(arena, list[j], mono);
+        if (incl == CONTAINS) {
+            list.erase(list.begin() + j);
+            if (j < i) i--;
+            continue;
+        }
+        if (incl == INCLUDED) return false;
+        j++;
+    }
+    return true;
+}
+
+// Monomial.prod, including Monomial.insert_deltas
+Mono product(Arena &arena, const Mono &m1, const Mono &m2) {
+    Mono result{prod_mwp(m1.scalar, m2.scalar), 0, 0};
+    if (result.scalar == O) return result;
+    std::vector<uint64_t> deltas(arena.at(m1), arena.at(m1) + m1.length);
+    const uint64_t *add = arena.at(m2);
+    for (uint32_t k = 0; k < m2.length; k++) {
+        uint64_t delta = add[k];
+        size_t i = 0;
+        bool skip = false;
+        while (i < deltas.size()) {
+            if ((deltas[i] >> 2) < (delta >> 2)) {
+                i++;
+            } else if ((deltas[i] >> 2) == (delta >> 2)) {
+                if (deltas[i] != delta) {
+                    deltas.clear();
+                    result.scalar = O;
+                }
+                skip = true;
+                break;
+            } else {
+                break;
+            }
+        }
+        if (result.scalar == O) break;
+        if (!skip) deltas.insert(deltas.begin() + i, delta);
+    }
+    result.offset = static_cast<uint32_t>(arena.deltas.size());
+    result.length = static_cast<uint32_t>(deltas.size());
+    arena.deltas.insert(arena.deltas.end(), deltas.begin(), deltas.end());
+    return result;
+}
+
+// Polynomial.remove_zeros
+void remove_zeros(Poly &poly) {
+    Poly filtered;
+    for (const Mono &m : poly)
+        if (m.scalar != O) filtered.push_back(m);
+    if (filtered.empty()) filtered.push_back(Mono{O, 0, 0});
+    poly.swap(filtered);
+}
+
+// Polynomial.sort_monomials
+Poly sort_monomials(const Arena &arena, const Mono *monomials, size_t n) {
+    if (n < 2) return Poly(monomials, monomials + n);
+    size_t mid = n / 2;
+    Poly left = sort_monomials(arena, monomials + mid, n - mid);
+    Poly right = sort_monomials(arena, monomials, mid);
+    Poly result;
+    size_t l = 0, r = 0;
+    while (l < left.size() && r < right.size()) {
+        Comparison c = compare(arena, left[l], right[r]);
+        if (c == SMALLER) {
+            result.push_back(left[l++]);
+        } else if (c == LARGER) {
+            result.push_back(right[r++]);
+        } else {
+            Mono m = left[l];
+            m.scalar = sum_mwp(left[l].scalar, right[r].scalar);
+            if (m.scalar != O) result.push_back(m);
+            l++;
+            r++;
+        }
+    }
+    result.insert(result.end(), right.begin() + r, right.end());
+    result.insert(result.end(), left.begin() + l, left.end());
+    return result;
+}
+
+// Polynomial.add
+Poly add(const Arena &arena, const Poly &p1, const Poly &p2) {
+    if (p1.empty() && p2.empty()) return Poly{Mono{O, 0, 0}};
+    if (p1.empty()) return p2;
+    if (p2.empty()) return p1;
+    Poly list = p1;
+    size_t i = 0, j = 0;
+    while (j < p2.size()) {
+        const Mono &mono2 = p2[j];
+        if (!include(arena, list, mono2, i)) {
+            j++;
+            continue;
+        }
+        if (i == list.size()) {
+            for (size_t k = j; k < p2.size(); k++)
+                if (include(arena, list, p2[k], i)) list.push_back(p2[k]);
+            break;
+        }
+        Comparison c = compare(arena, list[i], mono2);
+        if (c == SMALLER) {
+            i++;
+        } else if (c == LARGER) {
+            list.insert(list.begin() + i, mono2);
+            i++;
+            j++;
+        } else {
+            list[i].scalar = sum_mwp(list[i].scalar, mono2.scalar);
+            j++;
+        }
+    }
+    Poly result = sort_monomials(arena, list.data(), list.size());
+    remove_zeros(result);
+    return result;
+}
+
+// Polynomial.times
+Poly times(Arena &arena, const Poly &p1, const Poly &p2) {
+    std::vector<Poly> table;
+    for (const Mono &m2 : p2) {
+        Poly row;
+        for (const Mono &m1 : p1) {
+            Mono m = product(arena, m1, m2);
+            if (m.scalar != O) row.push_back(m);
+        }
+        if (!row.empty()) table.push_back(std::move(row));
+    }
+    if (table.empty()) return Poly{Mono{O, 0, 0}};
+
+    std::vector<size_t> head(table.size(), 0);
+    std::vector<size_t> index{0};
+    auto place = [&](size_t t) {
+        const Mono &t1 = table[t][head[t]];
+        for (size_t j = 0; j < index.size(); j++) {
+            if (compare(arena, t1, table[index[j]][head[index[j]]]) == SMALLER) {
+                index.insert(index.begin() + j, t);
+                return;
+            }
+        }
+        index.push_back(t);
+    };
+    for (size_t t = 1; t < table.size(); t++) place(t);
+
+    Poly result;
+    while (!index.empty()) {
+        size_t smallest = index.front();
+        index.erase(index.begin());
+        const Mono mono2 = table[smallest][head[smallest]++];
+        size_t ignored = 0;
+        if (include(arena, result, mono2, ignored)) result.push_back(mono2);
+        if (head[smallest] < table[smallest].size()) place(smallest);
+    }
+    remove_zeros(result);
+    return result;
+}
+
+// Polynomial.scale: product with a constant, one product for each
+// monomial of the other polynomial, stably sorted by deltas.
+Poly scale(Arena &arena, const Poly &p1, const Poly &p2) {
+    const bool left = p1.size() == 1 && p1[0].length == 0;
+    Poly products;
+    for (const Mono &m : left ? p2 : p1) {
+        Mono mono = left ? product(arena, p1[0], m) : product(arena, m, p2[0]);
+        if (mono.scalar != O) products.push_back(mono);
+    }
+    if (products.empty()) return Poly{Mono{O, 0, 0}};
+    if (left)
+        std::stable_sort(products.begin(), products.end(),
+                         [&](const Mono &a, const Mono &b) {
+                             return compare(arena, a, b) == SMALLER;
+                         });
+    Poly result;
+    for (const Mono &mono : products) {
+        size_t ignored = 0;
+        if (include(arena, result, mono, ignored)) result.push_back(mono);
+    }
+    remove_zeros(result);
+    return result;
+}
+
+bool infinite(const Poly &poly) {
+    for (const Mono &m : poly)
+        if (m.scalar == I) return true;
+    return false;
+}
+
+// Python objects ----------------------------------------------------------
+
+PyObject *monomial_type = nullptr;
+PyObject *polynomial_type = nullptr;
+PyObject *scalars[5] = {nullptr};
+PyObject *str_scalar = nullptr, *str_deltas = nullptr, *str_list = nullptr,
+         *str_infinite = nullptr;
+PyObject *empty_tuple = nullptr;
+std::unordered_map<uint64_t, PyObject *> delta_objects;
+
+int scalar_code(PyObject *scalar) {
+    if (!PyUnicode_Check(scalar) || PyUnicode_GET_LENGTH(scalar) != 1) return -1;
+    switch (PyUnicode_READ_CHAR(scalar, 0)) {
+        case 'o': return O;
+        case 'm': return M;
+        case 'w': return W;
+        case 'p': return P;
+        case 'i': return I;
+        default: return -1;
+    }
+}
+
+// Read list of monomials into poly.
+bool read_list(PyObject *list, Arena &arena, Poly &poly) {
+    PyObject *seq = PySequence_Fast(list, "expected list of monomials");
+    if (!seq) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    poly.reserve(n);
+    for (Py_ssize_t k = 0; k < n; k++) {
+        PyObject *scalar = PyObject_GetAttr(items[k], str_scalar);
+        PyObject *deltas = scalar ? PyObject_GetAttr(items[k], str_deltas) : nullptr;
+        PyObject *dseq = deltas ? PySequence_Fast(deltas, "expected deltas") : nullptr;
+        int code = scalar ? scalar_code(scalar) : -1;
+        bool ok = dseq != nullptr && code >= 0;
+        if (scalar && code < 0)
+            PyErr_SetString(PyExc_ValueError, "unknown scalar");
+        Mono mono{static_cast<uint8_t>(code < 0 ? 0 : code),
+                  static_cast<uint32_t>(arena.deltas.size()), 0};
+        if (ok) {
+            Py_ssize_t m = PySequence_Fast_GET_SIZE(dseq);
+            PyObject **ds = PySequence_Fast_ITEMS(dseq);
+            for (Py_ssize_t l = 0; l < m && ok; l++) {
+                unsigned long choice, index;
+                PyObject *pair = PySequence_Tuple(ds[l]);
+                ok = pair && PyArg_ParseTuple(pair, "kk", &choice, &index);
+                Py_XDECREF(pair);
+                if (!ok) break;
+                arena.deltas.push_back((static_cast<uint64_t>(index) << 2) | choice);
+            }
+            mono.length = static_cast<uint32_t>(m);
+        }
+        Py_XDECREF(dseq);
+        Py_XDECREF(deltas);
+        Py_XDECREF(scalar);
+        if (!ok) {
+            Py_DECREF(seq);
+            return false;
+        }
+        poly.push_back(mono);
+    }
+    Py_DECREF(seq);
+    return true;
+}
+
+bool read_polynomial(PyObject *polynomial, Arena &arena, Poly &poly) {
+    PyObject *list = PyObject_GetAttr(polynomial, str_list);
+    if (!list) return false;
+    bool ok = read_list(list, arena, poly);
+    Py_DECREF(list);
+    return ok;
+}
+
+// Releases the delta tuples cached while writing the results of one
+// kernel call, so that the cache does not outlive the call.
+struct DeltaObjects {
+    DeltaObjects() = default;
+    DeltaObjects(const DeltaObjects &) = delete;
+    DeltaObjects &operator=(const DeltaObjects &) = delete;
+    ~DeltaObjects() {
+        for (auto &entry : delta_objects) Py_DECREF(entry.second);
+        delta_objects.clear();
+    }
+};
+
+PyObject *delta_object(uint64_t delta) {
+    auto found = delta_objects.find(delta);
+    if (found != delta_objects.end()) {
+        Py_INCREF(found->second);
+        return found->second;
+    }
+    PyObject *tuple = Py_BuildValue(
+        "(KK)", static_cast<unsigned long long>(delta & 3),
+        static_cast<unsigned long long>(delta >> 2));
+    if (!tuple) return nullptr;
+    Py_INCREF(tuple);
+    delta_objects.emplace(delta, tuple);
+    return tuple;
+}
+
+// Create list of Monomial objects, without calling Monomial.__init__.
+PyObject *write_list(const Arena &arena, const Poly &poly) {
+    PyObject *list = PyList_New(static_cast<Py_ssize_t>(poly.size()));
+    if (!list) return nullptr;
+    for (size_t k = 0; k < poly.size(); k++) {
+        const Mono &m = poly[k];
+        PyObject *deltas = PyList_New(m.length);
+        PyObject *mono = deltas ? PyBaseObject_Type.tp_new(
+            reinterpret_cast<PyTypeObject *>(monomial_type), empty_tuple, nullptr) : nullptr;
+        bool ok = mono != nullptr;
+        const uint64_t *ds = arena.at(m);
+        for (uint32_t l = 0; ok && l < m.length; l++) {
+            PyObject *delta = delta_object(ds[l]);
+            ok = delta != nullptr;
+            if (ok) PyList_SET_ITEM(deltas, l, delta);
+        }
+        ok = ok && PyObject_SetAttr(mono, str_deltas, deltas) == 0 &&
+             PyObject_SetAttr(mono, str_scalar, scalars[m.scalar]) == 0;
+        Py_XDECREF(deltas);
+        if (!ok) {
+            Py_XDECREF(mono);
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, k, mono);
+    }
+    return list;
+}
+
+// Deltas of infinite monomials, as recorded in Polynomial.infinite.
+PyObject *write_infinite(const Arena &arena, const Poly &poly) {
+    PyObject *list = PyList_New(0);
+    for (size_t k = 0; list && k < poly.size(); k++) {
+        const Mono &m = poly[k];
+        if (m.scalar != I) continue;
+        PyObject *deltas = PyTuple_New(m.length);
+        const uint64_t *ds = arena.at(m);
+        for (uint32_t l = 0; deltas && l < m.length; l++) {
+            PyObject *delta = delta_object(ds[l]);
+            if (!delta) Py_CLEAR(deltas);
+            else PyTuple_SET_ITEM(deltas, l, delta);
+        }
+        if (!deltas || PyList_Append(list, deltas) < 0) Py_CLEAR(list);
+        Py_XDECREF(deltas);
+    }
+    return list;
+}
+
+// Monomials and infinite deltas of a result.
+PyObject *write_result(const Arena &arena, const Poly &poly) {
+    DeltaObjects objects;
+    PyObject *list = write_list(arena, poly);
+    PyObject *infinite = list ? write_infinite(arena, poly) : nullptr;
+    PyObject *result = infinite ? PyTuple_Pack(2, list, infinite) : nullptr;
+    Py_XDECREF(infinite);
+    Py_XDECREF(list);
+    return result;
+}
+
+PyObject *write_polynomial(const Arena &arena, const Poly &poly) {
+    PyObject *list = write_list(arena, poly);
+    if (!list) return nullptr;
+    PyObject *result = PyObject_CallFunctionObjArgs(polynomial_type, list, nullptr);
+    Py_DECREF(list);
+    PyObject *infinite = result ? write_infinite(arena, poly) : nullptr;
+    if (!infinite || PyObject_SetAttr(result, str_infinite, infinite) < 0)
+        Py_CLEAR(result);
+    Py_XDECREF(infinite);
+    return result;
+}
+
+bool ready() {
+    if (monomial_type && polynomial_type) return true;
+    PyErr_SetString(PyExc_RuntimeError, "native algebra is not initialized");
+    return false;
+}
+
+// Read matrix whose entries are polynomials or None (missing).
+bool read_matrix(PyObject *matrix, Arena &arena, std::vector<std::vector<Poly>> &polys,
+                 std::vector<std::vector<char>> &missing) {
+    PyObject *rows = PySequence_Fast(matrix, "expected matrix");
+    if (!rows) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(rows);
+    polys.assign(n, {});
+    missing.assign(n, {});
+    for (Py_ssize_t i = 0; i < n; i++) {
+        PyObject *row = PySequence_Fast(PySequence_Fast_GET_ITEM(rows, i), "expected row");
+        if (!row) {
+            Py_DECREF(rows);
+            return false;
+        }
+        Py_ssize_t m = PySequence_Fast_GET_SIZE(row);
+        polys[i].resize(m);
+        missing[i].assign(m, 0);
+        for (Py_ssize_t j = 0; j < m; j++) {
+            PyObject *item = PySequence_Fast_GET_ITEM(row, j);
+            if (item == Py_None) {
+                missing[i][j] = 1;
+            } else if (!read_polynomial(item, arena, polys[i][j])) {
+                Py_DECREF(row);
+                Py_DECREF(rows);
+                return false;
+            }
+        }
+        Py_DECREF(row);
+    }
+    Py_DECREF(rows);
+    return true;
+}
+
+// Module functions --------------------------------------------------------
+
+PyObject *init(PyObject *, PyObject *args) {
+    PyObject *monomial, *polynomial;
+    if (!PyArg_ParseTuple(args, "OO", &monomial, &polynomial)) return nullptr;
+    if (!PyType_Check(monomial) || !PyType_Check(polynomial)) {
+        PyErr_SetString(PyExc_TypeError, "expected Monomial and Polynomial types");
+        return nullptr;
+    }
+    Py_INCREF(monomial);
+    Py_INCREF(polynomial);
+    Py_XDECREF(monomial_type);
+    Py_XDECREF(polynomial_type);
+    monomial_type = monomial;
+    polynomial_type = polynomial;
+    Py_RETURN_NONE;
+}
+
+PyObject *py_add(PyObject *, PyObject *args) {
+    PyObject *l1, *l2;
+    if (!PyArg_ParseTuple(args, "OO", &l1, &l2) || !ready()) return nullptr;
+    Arena arena;
+    Poly p1, p2;
+    if (!read_list(l1, arena, p1) || !read_list(l2, arena, p2)) return nullptr;
+    return write_result(arena, add(arena, p1, p2));
+}
+
+PyObject *py_times(PyObject *, PyObject *args) {
+    PyObject *l1, *l2;
+    if (!PyArg_ParseTuple(args, "OO", &l1, &l2) || !ready()) return nullptr;
+    Arena arena;
+    Poly p1, p2;
+    if (!read_list(l1, arena, p1) || !read_list(l2, arena, p2)) return nullptr;
+    return write_result(arena, times(arena, p1, p2));
+}
+
+PyObject *py_scale(PyObject *, PyObject *args) {
+    PyObject *l1, *l2;
+    if (!PyArg_ParseTuple(args, "OO", &l1, &l2) || !ready()) return nullptr;
+    Arena arena;
+    Poly p1, p2;
+    if (!read_list(l1, arena, p1) || !read_list(l2, arena, p2)) return nullptr;
+    return write_result(arena, scale(arena, p1, p2));
+}
+
+// Iterate rows argument and compute one output row for each.
+template <typename Cell>
+PyObject *map_rows(PyObject *rows, size_t columns, Arena &arena, Cell cell) {
+    PyObject *iter = PyObject_GetIter(rows);
+    if (!iter) return nullptr;
+    DeltaObjects objects;
+    PyObject *result = PyList_New(0);
+    size_t mark = arena.deltas.size();
+    PyObject *item;
+    while (result && (item = PyIter_Next(iter))) {
+        Py_ssize_t i = PyLong_AsSsize_t(item);
+        Py_DECREF(item);
+        PyObject *row = (i < 0 && PyErr_Occurred()) ? nullptr : PyList_New(columns);
+        for (size_t j = 0; row && j < columns; j++) {
+            PyObject *poly = cell(static_cast<size_t>(i), j);
+            // intermediate deltas of the cell are no longer needed
+            arena.deltas.resize(mark);
+            if (!poly) Py_CLEAR(row);
+            else PyList_SET_ITEM(row, j, poly);
+        }
+        if (!row || PyList_Append(result, row) < 0) Py_CLEAR(result);
+        Py_XDECREF(row);
+    }
+    Py_DECREF(iter);
+    if (PyErr_Occurred()) Py_CLEAR(result);
+    return result;
+}
+
+PyObject *py_prod_rows(PyObject *, PyObject *args) {
+    PyObject *m1, *m2, *rows, *zero;
+    if (!PyArg_ParseTuple(args, "OOOO", &m1, &m2, &rows, &zero) || !ready())
+        return nullptr;
+    Arena arena;
+    std::vector<std::vector<Poly>> a, b;
+    std::vector<std::vector<char>> na, nb;
+    Poly z;
+    if (!read_matrix(m1, arena, a, na) || !read_matrix(m2, arena, b, nb) ||
+        !read_polynomial(zero, arena, z))
+        return nullptr;
+    size_t n = a.size(), columns = b.size();
+    return map_rows(rows, columns, arena, [&](size_t i, size_t j) -> PyObject * {
+        if (n == 0) {
+            Py_INCREF(zero);
+            return zero;
+        }
+        Poly total = z;
+        for (size_t k = 0; k < n; k++)
+            total = add(arena, total, times(arena, a[i][k], b[k][j]));
+        return write_polynomial(arena, total);
+    });
+}
+
+PyObject *py_extended_rows(PyObject *, PyObject *args) {
+    PyObject *m1, *m2, *rows, *zero, *unit;
+    if (!PyArg_ParseTuple(args, "OOOOO", &m1, &m2, &rows, &zero, &unit) || !ready())
+        return nullptr;
+    Arena arena;
+    std::vector<std::vector<Poly>> a, b;
+    std::vector<std::vector<char>> na, nb;
+    Poly z, u;
+    if (!read_matrix(m1, arena, a, na) || !read_matrix(m2, arena, b, nb) ||
+        !read_polynomial(zero, arena, z) || !read_polynomial(unit, arena, u))
+        return nullptr;
+    std::vector<std::vector<char>> ia(a.size()), ib(b.size());
+    for (size_t i = 0; i < a.size(); i++)
+        for (const Poly &p : a[i]) ia[i].push_back(infinite(p));
+    for (size_t i = 0; i < b.size(); i++)
+        for (const Poly &p : b[i]) ib[i].push_back(infinite(p));
+    size_t size = a.size();
+    return map_rows(rows, size, arena, [&](size_t i, size_t j) -> PyObject * {
+        Poly total;
+        bool changed = false;
+        for (size_t k = 0; k < size; k++) {
+            const Poly *x = &a[i][k], *y = &b[k][j];
+            if (na[i][k]) {
+                if (i != k) {
+                    if (nb[k][j] || !ib[k][j]) continue;
+                    x = &z;
+                } else if (nb[k][j]) {
+                    if (k == j) {
+                        total = add(arena, changed ? total : z, u);
+                        changed = true;
+                    }
+                    continue;
+                } else {
+                    x = &u;
+                }
+            } else if (nb[k][j]) {
+                if (k != j) {
+                    if (!ia[i][k]) continue;
+                    y = &z;
+                } else {
+                    y = &u;
+                }
+            }
+            total = add(arena, changed ? total : z, times(arena, *x, *y));
+            changed = true;
+        }
+        if (!changed) {
+            Py_INCREF(zero);
+            return zero;
+        }
+        return write_polynomial(arena, total);
+    });
+}
+
+// Product of dense n x n scalar matrices, one byte per scalar. For each
+// term A[i][k] the whole row k of B is combined at once, without branches,
+// so that the inner loop vectorizes.
+PyObject *py_scalar_prod(PyObject *, PyObject *args) {
+    Py_buffer a, b;
+    Py_ssize_t n;
+    if (!PyArg_ParseTuple(args, "y*y*n", &a, &b, &n)) return nullptr;
+    PyObject *result = nullptr;
+    if (a.len != n * n || b.len != n * n) {
+        PyErr_SetString(PyExc_ValueError, "matrix size mismatch");
+    } else if ((result = PyBytes_FromStringAndSize(nullptr, n * n))) {
+        const uint8_t *da = static_cast<const uint8_t *>(a.buf);
+        const uint8_t *db = static_cast<const uint8_t *>(b.buf);
+        uint8_t *out = reinterpret_cast<uint8_t *>(PyBytes_AS_STRING(result));
+        std::fill(out, out + n * n, uint8_t(O));
+        for (Py_ssize_t i = 0; i < n; i++) {
+            uint8_t *row = out + i * n;
+            for (Py_ssize_t k = 0; k < n; k++) {
+                const uint8_t x = da[i * n + k], *col = db + k * n;
+                // prod_mwp(x, y): the larger scalar, which is i if either is
+                // i, and otherwise o if either is o
+                const uint8_t nonzero = x != O ? 0xFF : 0;
+                for (Py_ssize_t j = 0; j < n; j++) {
+                    uint8_t y = col[j], m = x > y ? x : y;
+                    uint8_t keep = uint8_t(-uint8_t(m == I) | (nonzero & -uint8_t(y != O)));
+                    uint8_t v = uint8_t(m & keep);
+                    row[j] = row[j] > v ? row[j] : v;
+                }
+            }
+        }
+    }
+    PyBuffer_Release(&a);
+    PyBuffer_Release(&b);
+    return result;
+}
+
+// Sum of dense scalar matrices: their larger scalar at each entry.
+PyObject *py_scalar_sum(PyObject *, PyObject *args) {
+    Py_buffer a, b;
+    if (!PyArg_ParseTuple(args, "y*y*", &a, &b)) return nullptr;
+    PyObject *result = nullptr;
+    if (a.len != b.len) {
+        PyErr_SetString(PyExc_ValueError, "matrix size mismatch");
+    } else if ((result = PyBytes_FromStringAndSize(nullptr, a.len))) {
+        const uint8_t *da = static_cast<const uint8_t *>(a.buf);
+        const uint8_t *db = static_cast<const uint8_t *>(b.buf);
+        uint8_t *out = reinterpret_cast<uint8_t *>(PyBytes_AS_STRING(result));
+        for (Py_ssize_t k = 0; k < a.len; k++) out[k] = da[k] > db[k] ? da[k] : db[k];
+    }
+    PyBuffer_Release(&a);
+    PyBuffer_Release(&b);
+    return result;
+}
+
+PyMethodDef methods[] = {
+    {"init", init, METH_VARARGS,
+     "Register the Monomial and Polynomial classes."},
+    {"add", py_add, METH_VARARGS,
+     "Sum of two lists of monomials, as Polynomial.add; returns monomials "
+     "and deltas of infinite monomials."},
+    {"times", py_times, METH_VARARGS,
+     "Product of two lists of monomials, as Polynomial.times; returns "
+     "monomials and deltas of infinite monomials."},
+    {"scale", py_scale, METH_VARARGS,
+     "Product of two lists of monomials, one of which is a constant, as "
+     "Polynomial.scale; returns monomials and deltas of infinite "
+     "monomials."},
+    {"prod_rows", py_prod_rows, METH_VARARGS,
+     "Rows of the product of two polynomial matrices."},
+    {"extended_rows", py_extended_rows, METH_VARARGS,
+     "Rows of the product of two matrices that are implicitly identity "
+     "where their entries are None."},
+    {"scalar_prod", py_scalar_prod, METH_VARARGS,
+     "Product of two dense n x n scalar matrices, as bytes."},
+    {"scalar_sum", py_scalar_sum, METH_VARARGS,
+     "Sum of two dense scalar matrices, as bytes."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef module = {PyModuleDef_HEAD_INIT,
+                      "_algebra",
+                      "Native kernels of the polynomial algebra.",
+                      -1,
+                      methods,
+                      nullptr,
+                      nullptr,
+                      nullptr,
+                      nullptr};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit__algebra(void) {
+    const char *names[] = {"o", "m", "w", "p", "i"};
+    for (int k = 0; k < 5; k++) {
+        scalars[k] = PyUnicode_InternFromString(names[k]);
+        if (!scalars[k]) return nullptr;
+    }
+    str_scalar = PyUnicode_InternFromString("scalar");
+    str_deltas = PyUnicode_InternFromString("deltas");
+    str_list = PyUnicode_InternFromString("list");
+    str_infinite = PyUnicode_InternFromString("infinite");
+    empty_tuple = PyTuple_New(0);
+    if (!str_scalar || !str_deltas || !str_list || !str_infinite || !empty_tuple) return nullptr;
+    return PyModule_Create(&module);
+}
@@ -0,0 +1,347 @@
+// Native reduction of delta sequences and generation of choice vectors.
+//
+// Only the Choices API uses this extension; the analysis evaluates choices
+// with a decision diagram (ChoiceDiagram in pymwp/mdd.py) instead.
+//
+// This extension computes the same results as the pure-Python methods of
+// Choices (pymwp/choice.py), and in the same order, so that the Python
+// sets it updates or the vectors it returns are identical to those of the
+// Python implementation. A delta sequence is read as its (choice, index)
+// pairs, and, for subset tests, as sorted distinct keys index << 32 |
+// choice. Shorter sequences that subsume longer ones are kept in a trie,
+// and choice vectors are built by backtracking over one delta per
+// sequence, pruning a branch as soon as all choices at some index are
+// excluded.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Delta = std::pair<long long, long long>;  // (choice, index)
+using Sequence = std::vector<Delta>;
+using Keys = std::vector<uint64_t>;
+
+// Read one delta sequence, a sequence of (choice, index) pairs.
+bool read_sequence(PyObject *object, Sequence &sequence) {
+    PyObject *items = PySequence_Fast(object, "delta sequence must be a sequence");
+    if (!items) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(items);
+    sequence.resize(n);
+    bool ok = true;
+    for (Py_ssize_t k = 0; k < n && ok; k++) {
+        PyObject *delta = PySequence_Fast_GET_ITEM(items, k);
+        PyObject *pair = PySequence_Fast(delta, "delta must be a pair");
+        ok = pair && PySequence_Fast_GET_SIZE(pair) == 2;
+        if (ok) {
+            sequence[k].first = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(pair, 0));
+            sequence[k].second = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(pair, 1));
+            ok = !PyErr_Occurred();
+        } else if (pair) {
+            PyErr_SetString(PyExc_ValueError, "delta must be a pair");
+        }
+        Py_XDECREF(pair);
+    }
+    Py_DECREF(items);
+    return ok;
+}
+
+// Sorted distinct keys of a sequence, compared as sets of deltas.
+bool read_keys(const Sequence &sequence, Keys &keys) {
+    keys.clear();
+    for (const Delta &d : sequence) {
+        if (d.first < 0 || d.first > UINT32_MAX || d.second < 0 || d.second > UINT32_MAX) {
+            PyErr_SetString(PyExc_ValueError, "delta out of range");
+            return false;
+        }
+        keys.push_back(uint64_t(d.second) << 32 | uint64_t(d.first));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return true;
+}
+
+// set(a).issubset(set(b)), on sorted distinct keys
+bool subset(const Keys &a, const Keys &b) {
+    return std::includes(b.begin(), b.end(), a.begin(), a.end());
+}
+
+// Trie of kept sequences, over their sorted keys.
+struct Trie {
+    struct Node {
+        bool end = false;
+        std::map<uint64_t, size_t> children;
+    };
+    std::vector<Node> nodes{1};
+
+    void insert(const Keys &keys) {
+        size_t node = 0;
+        for (uint64_t key : keys) {
+            auto found = nodes[node].children.find(key);
+            if (found == nodes[node].children.end()) {
+                nodes.emplace_back();
+                found = nodes[node].children.emplace(key, nodes.size() - 1).first;
+            }
+            node = found->second;
+        }
+        nodes[node].end = true;
+    }
+
+    // Some kept sequence is a subset of keys[from:].
+    bool covers(const Keys &keys, size_t node = 0, size_t from = 0) const {
+        if (nodes[node].end) return true;
+        const auto &children = nodes[node].children;
+        for (size_t k = from; k < keys.size(); k++) {
+            auto found = children.find(keys[k]);
+            if (found != children.end() && covers(keys, found->second, k + 1)) return true;
+        }
+        return false;
+    }
+};
+
+// Choices.unique_sequences: sequences in order of length, without those
+// that contain a shorter one; returned in the order Python adds them.
+PyObject *py_unique_sequences(PyObject *, PyObject *args) {
+    PyObject *infinities;
+    if (!PyArg_ParseTuple(args, "O", &infinities)) return nullptr;
+    PyObject *items = PySequence_List(infinities);
+    if (!items) return nullptr;
+    Py_ssize_t n = PyList_GET_SIZE(items);
+    std::vector<Keys> keys(n);
+    std::vector<size_t> lengths(n);
+    Sequence sequence;
+    for (Py_ssize_t k = 0; k < n; k++) {
+        if (!read_sequence(PyList_GET_ITEM(items, k), sequence) ||
+            !read_keys(sequence, keys[k])) {
+            Py_DECREF(items);
+            return nullptr;
+        }
+        lengths[k] = sequence.size();
+    }
+    std::vector<Py_ssize_t> order(n);
+    for (Py_ssize_t k = 0; k < n; k++) order[k] = k;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](Py_ssize_t a, Py_ssize_t b) { return lengths[a] < lengths[b]; });
+    Trie kept;
+    PyObject *result = PyList_New(0);
+    for (Py_ssize_t k : order) {
+        if (!result) break;
+        if (kept.covers(keys[k])) continue;
+        kept.insert(keys[k]);
+        if (PyList_Append(result, PyList_GET_ITEM(items, k)) < 0) Py_CLEAR(result);
+    }
+    Py_DECREF(items);
+    return result;
+}
+
+// Choices.reduce: replace the first reducible sequence, in iteration
+// order of the set; returns 1 if reduced, 0 if not, -1 on error.
+int reduce(const std::set<long long> &choices, PyObject *sequences) {
+    PyObject *items = PySequence_List(sequences);
+    if (!items) return -1;
+    Py_ssize_t n = PyList_GET_SIZE(items);
+    std::vector<Sequence> seqs(n);
+    for (Py_ssize_t k = 0; k < n; k++) {
+        if (!read_sequence(PyList_GET_ITEM(items, k), seqs[k])) {
+            Py_DECREF(items);
+            return -1;
+        }
+    }
+    // Choices.sub_equal: same first index and same rest
+    std::map<Sequence, std::set<long long>> subs;
+    for (const Sequence &s : seqs) {
+        if (s.empty()) continue;
+        Sequence key(s.begin(), s.end());
+        key[0].first = 0;
+        subs[key].insert(s[0].first);
+    }
+    int reduced = 0;
+    for (Py_ssize_t k = 0; k < n && !reduced; k++) {
+        const Sequence &s1 = seqs[k];
+        if (s1.size() < 2) continue;
+        Sequence key(s1.begin(), s1.end());
+        key[0].first = 0;
+        if (subs[key] != choices) continue;
+        PyObject *item = PyList_GET_ITEM(items, k);
+        PyObject *keep = PySequence_GetSlice(item, 1, PyObject_Length(item));
+        Keys rest, other;
+        bool ok = keep && read_keys(Sequence(s1.begin() + 1, s1.end()), rest);
+        // Choices.remove_subset, then add the shorter sequence
+        for (Py_ssize_t l = 0; l < n && ok; l++) {
+            ok = read_keys(seqs[l], other) &&
+                 (!subset(rest, other) || PySet_Discard(sequences, PyList_GET_ITEM(items, l)) >= 0);
+        }
+        ok = ok && PySet_Add(sequences, keep) == 0;
+        Py_XDECREF(keep);
+        reduced = ok ? 1 : -1;
+    }
+    Py_DECREF(items);
+    return reduced;
+}
+
+bool read_choices(PyObject *object, std::vector<long long> &values) {
+    PyObject *items = PySequence_Fast(object, "choices must be a sequence");
+    if (!items) return false;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(items);
+    values.resize(n);
+    for (Py_ssize_t k = 0; k < n; k++)
+        values[k] = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(items, k));
+    Py_DECREF(items);
+    return !PyErr_Occurred();
+}
+
+// Choices.reduce_subsequences
+PyObject *py_reduce_subsequences(PyObject *, PyObject *args) {
+    PyObject *choices, *sequences;
+    if (!PyArg_ParseTuple(args, "OO!", &choices, &PySet_Type, &sequences)) return nullptr;
+    std::vector<long long> values;
+    if (!read_choices(choices, values)) return nullptr;
+    std::set<long long> choice_set(values.begin(), values.end());
+    int reduced;
+    while ((reduced = reduce(choice_set, sequences)) == 1) {
+    }
+    if (reduced < 0) return nullptr;
+    Py_RETURN_NONE;
+}
+
+// Choices.build_choices, for sorted infinity paths: the vectors, as
+// tuples of tuples, in the order Python adds them to its set. Returns
+// None when the Python implementation must be used instead: choices
+// outside 0..7, whose sets Python may not iterate in increasing order,
+// or deltas that are not valid choices at valid indices.
+PyObject *py_build_choices(PyObject *, PyObject *args) {
+    PyObject *choices, *paths;
+    Py_ssize_t index;
+    if (!PyArg_ParseTuple(args, "OnO", &choices, &index, &paths)) return nullptr;
+    std::vector<long long> values;
+    if (!read_choices(choices, values)) return nullptr;
+    uint8_t full = 0;
+    for (long long c : values) {
+        if (c < 0 || c > 7 || (full & (1 << c))) Py_RETURN_NONE;
+        full |= uint8_t(1 << c);
+    }
+    PyObject *items = PySequence_Fast(paths, "paths must be a sequence");
+    if (!items) return nullptr;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(items);
+    std::vector<Sequence> seqs(n);
+    bool valid = true;
+    for (Py_ssize_t k = 0; k < n; k++) {
+        if (!read_sequence(PySequence_Fast_GET_ITEM(items, k), seqs[k])) {
+            Py_DECREF(items);
+            return nullptr;
+        }
+        for (const Delta &d : seqs[k])
+            valid = valid && d.first >= 0 && d.first <= 7 && (full & (1 << d.first)) &&
+                    d.second >= 0 && d.second < index;
+    }
+    Py_DECREF(items);
+    if (!valid) Py_RETURN_NONE;
+
+    // remaining choices for each mask of excluded choices
+    PyObject *entries[256] = {nullptr};
+    PyObject *result = PyList_New(0);
+    std::vector<uint8_t> masks(index, 0);
+    std::vector<size_t> pos(n + 1, 0);
+    std::vector<long long> undo(n, -1);
+    auto entry = [&](uint8_t mask) -> PyObject * {
+        if (!entries[mask]) {
+            std::vector<long long> remaining;
+            for (long long c = 0; c < 8; c++)
+                if ((full & ~mask) & (1 << c)) remaining.push_back(c);
+            PyObject *tuple = PyTuple_New(remaining.size());
+            for (size_t k = 0; tuple && k < remaining.size(); k++) {
+                PyObject *value = PyLong_FromLongLong(remaining[k]);
+                if (!value) Py_CLEAR(tuple);
+                else PyTuple_SET_ITEM(tuple, k, value);
+            }
+            entries[mask] = tuple;
+        }
+        return entries[mask];
+    };
+    auto emit = [&]() -> bool {
+        PyObject *vector = PyTuple_New(index);
+        for (Py_ssize_t k = 0; vector && k < index; k++) {
+            PyObject *e = entry(masks[k]);
+            if (!e) {
+                Py_CLEAR(vector);
+                break;
+            }
+            Py_INCREF(e);
+            PyTuple_SET_ITEM(vector, k, e);
+        }
+        bool ok = vector && PyList_Append(result, vector) == 0;
+        Py_XDECREF(vector);
+        return ok;
+    };
+    auto restore = [&](size_t depth) {
+        if (undo[depth] >= 0) masks[undo[depth] >> 3] &= uint8_t(~(1 << (undo[depth] & 7)));
+    };
+    // one delta per path, paths in order and deltas of the first path
+    // varying slowest, as the iterations of the Python implementation
+    size_t depth = 0;
+    while (result) {
+        if (depth == size_t(n)) {
+            if (!emit()) Py_CLEAR(result);
+            if (depth == 0) break;
+            restore(--depth);
+            pos[depth]++;
+            continue;
+        }
+        if (pos[depth] == seqs[depth].size()) {
+            if (depth == 0) break;
+            restore(--depth);
+            pos[depth]++;
+            continue;
+        }
+        const Delta &d = seqs[depth][pos[depth]];
+        uint8_t bit = uint8_t(1 << d.first);
+        if (masks[d.second] & bit) {
+            undo[depth] = -1;
+        } else {
+            masks[d.second] |= bit;
+            undo[depth] = d.second << 3 | d.first;
+        }
+        if (masks[d.second] == full) {
+            // all choices at this index are excluded
+            restore(depth);
+            pos[depth]++;
+            continue;
+        }
+        pos[++depth] = 0;
+    }
+    for (PyObject *e : entries) Py_XDECREF(e);
+    return result;
+}
+
+PyMethodDef methods[] = {
+    {"unique_sequences", py_unique_sequences, METH_VARARGS,
+     "Delta sequences not covered by a shorter one, as "
+     "Choices.unique_sequences, in the order they are added to its set."},
+    {"reduce_subsequences", py_reduce_subsequences, METH_VARARGS,
+     "Reduce a set of delta sequences in place, as "
+     "Choices.reduce_subsequences."},
+    {"build_choices", py_build_choices, METH_VARARGS,
+     "Choice vectors excluding sorted infinity paths, as "
+     "Choices.build_choices, or None if not supported."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef module = {PyModuleDef_HEAD_INIT,
+                      "_choice",
+                      "Native reduction of delta sequences and choice vectors.",
+                      -1,
+                      methods,
+                      nullptr,
+                      nullptr,
+                      nullptr,
+                      nullptr};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit__choice(void) { return PyModule_Create(&module); }
@@ -0,0 +1,75 @@
+"""
+Operation budgets for the example corpus.
+
+Each example in `c_files` has a budget: the largest allowed count of each
+kernel operation recorded by [`Counters`](../docs/counters.md). The
+counts are deterministic, so a test that exceeds its budget indicates that
+a change made the analysis do more work, independently of machine load.
+
+When a change reduces the work, lower the budgets by regenerating them:
+
+```
+python3 -m tests.budget
+```
+"""
+
+import json
+import os
+from typing import Dict
+
+from pymwp import Analysis
+from pymwp.counters import Counters
+from pymwp.file_io import parse
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BUDGETS = os.path.join(os.path.dirname(__file__), 'budgets.json')
+CORPUS = os.path.join(ROOT, 'c_files')
+
+
+def corpus() -> list:
+    """List C files of the example corpus, relative to repository root."""
+    return sorted(
+        os.path.relpath(os.path.join(path, name), ROOT)
+        for path, _, files in os.walk(CORPUS)
+        for name in files if name.endswith('.c'))
+
+
+def load_budgets() -> Dict[str, Dict[str, int]]:
+    """Load operation budgets by C file."""
+    with open(BUDGETS) as infile:
+        return json.load(infile)
+
+
+def count_operations(c_file: str) -> Dict[str, int]:
+    """Analyze C file and count kernel operations.
+
+    Arguments:
+        c_file: path to C file, relative to repository root
+
+    Returns:
+        Operation counts.
+    """
+    ast = parse(os.path.join(ROOT, c_file))
+    with Counters() as counters:
+        Analysis.run(ast, no_save=True)
+    return counters.counts
+
+
+def assert_within_budget(c_file: str, budget: Dict[str, int]) -> None:
+    """Assert that analysis of C file stays within its budget.
+
+    Arguments:
+        c_file: path to C file, relative to repository root
+        budget: maximum count of each operation
+    """
+    counts = count_operations(c_file)
+    over = {name: f'{counts[name]} > {limit}'
+            for name, limit in budget.items() if counts[name] > limit}
+    assert not over, f'{c_file} exceeds operation budget: {over}'
+
+
+if __name__ == '__main__':
+    budgets = {c_file: count_operations(c_file) for c_file in corpus()}
+    with open(BUDGETS, 'w') as outfile:
+        json.dump(budgets, outfile, indent=4)
+        outfile.write('\n')
@@ -1,4 +1,7 @@
+import logging
+
 from pymwp import Analysis, Polynomial
+from pymwp.file_io import iterate_relations
 from .mocks.ast_mocks import \
     INFINITE_2C, NOT_INFINITE_2C, IF_WO_BRACES, IF_WITH_BRACES, \
     VARIABLE_IGNORED, BRACES_ISSUES, PARAMS, FUNCTION_CALL, INFINITE_8C
@@ -128,3 +131,26 @@ def test_analysis_returns_all_functions():
 
     assert not f_infty
     assert set(foo.variables) == {'X1', 'X2'}
+
+
+def test_analysis_streams_results(tmp_path):
+    """Streaming analysis writes one line per function and keeps only the
+    last function in memory."""
+    file_out = str(tmp_path / "result.ndjson")
+    result = Analysis.run(FUNCTION_CALL, file_out, stream=True)
+
+    names = [name for name, _ in iterate_relations(file_out)]
+    assert names == ['f', 'foo']
+    assert list(result.keys()) == ['foo']
+
+
+def test_analysis_does_not_render_disabled_logs(mocker):
+    """When log level hides info messages, result matrix is never
+    converted to string."""
+    logging.getLogger('pymwp').setLevel(logging.CRITICAL)
+    to_str = mocker.patch('pymwp.relation_list.RelationList.__str__')
+    try:
+        Analysis.run(NOT_INFINITE_2C, no_save=True)
+    finally:
+        logging.getLogger('pymwp').setLevel(logging.NOTSET)
+    to_str.assert_not_called()
@@ -0,0 +1,77 @@
+from pymwp import Polynomial, Relation, RelationList
+from pymwp.blocks import BlockRelation
+from pymwp.variables import VariableTable
+
+VARIABLES = ['X0', 'X1', 'X2', 'X3', 'X4']
+
+
+def statement(target, source, index):
+    """Relation of assignment target = source, with choice at index."""
+    o, m = Polynomial('o'), Polynomial('m')
+    return Relation([source, target], [
+        [m, Polynomial.from_scalars(index, 'm', 'w', 'p')], [o, o]])
+
+
+def compose(statements, start):
+    for relation in statements:
+        start = start * relation
+    return start
+
+
+def test_independent_statements_stay_in_blocks():
+    """Statements over disjoint variables are separate blocks until a
+    statement connects them; the result equals full composition."""
+    statements = [statement('X0', 'X1', 0), statement('X2', 'X3', 1),
+                  statement('X4', 'X0', 2)]
+    with VariableTable(VARIABLES):
+        blocks = BlockRelation(VARIABLES)
+        sizes = []
+        for relation in statements:
+            blocks = blocks * relation
+            sizes.append(sorted(len(b.variables) for b in blocks.blocks))
+        expected = compose(statements, Relation.identity(VARIABLES))
+    assert sizes == [[2], [2, 2], [2, 3]]
+    assert str(blocks) == str(expected)
+    assert blocks.matrix == expected.matrix
+
+
+def test_infinity_merges_all_blocks():
+    """Composition with a relation that has infinity uses all variables."""
+    loop = Relation(['X2'], [[Polynomial.from_scalars(1, 'm', 'i')]])
+    statements = [statement('X0', 'X1', 0), loop]
+    with VariableTable(VARIABLES):
+        blocks = compose(statements, BlockRelation(VARIABLES))
+        expected = compose(statements, Relation.identity(VARIABLES))
+    assert [b.variables for b in blocks.blocks] == [VARIABLES]
+    assert str(blocks) == str(expected)
+
+
+def test_equal_compares_blocks():
+    """Block relations are equal when their blocks are, also when the
+    blocks cover different variables."""
+    with VariableTable(VARIABLES):
+        first = compose([statement('X0', 'X1', 0), statement('X2', 'X3', 1)],
+                        BlockRelation(VARIABLES))
+        same = compose([statement('X0', 'X1', 0), statement('X2', 'X3', 1)],
+                       BlockRelation(VARIABLES))
+        other = compose([statement('X0', 'X1', 0), statement('X2', 'X3', 2)],
+                        BlockRelation(VARIABLES))
+        wider = BlockRelation(VARIABLES, first.blocks + [
+            Relation.identity(['X4'])])
+    assert first.equal(same)
+    assert not first.equal(other)
+    assert first.equal(wider)
+
+
+def test_composition_does_not_assemble_matrix():
+    """Composing a relation list of block relations does not build the
+    matrix over all variables."""
+    statements = [statement('X0', 'X1', 0), statement('X2', 'X3', 1)]
+    with VariableTable(VARIABLES):
+        rel_list = RelationList(relation_list=[BlockRelation(VARIABLES)])
+        for relation in statements:
+            rel_list.composition(RelationList(relation_list=[relation]))
+        rel_list.composition(RelationList(relation_list=[
+            statement('X4', 'X0', 2), statement('X4', 'X0', 3)]))
+    assert len(rel_list.relations) == 2
+    assert all(rel._matrix is None for rel in rel_list.relations)
@@ -0,0 +1,14 @@
+import pytest
+
+from .budget import assert_within_budget, corpus, load_budgets
+
+BUDGETS = load_budgets()
+
+
+def test_every_example_has_budget():
+    assert sorted(BUDGETS) == corpus()
+
+
+@pytest.mark.parametrize('c_file', sorted(BUDGETS))
+def test_example_within_operation_budget(c_file):
+    assert_within_budget(c_file, BUDGETS[c_file])
@@ -0,0 +1,107 @@
+from copy import deepcopy
+
+from pycparser import c_parser
+
+from pymwp import Analysis, backend, workers
+from pymwp.calls import CallGraph
+from .mocks.ast_mocks import FUNCTION_CALL, INFINITE_2C
+
+SOURCE = """
+int f(int X1, int X2) { while (X1) { X2 = X1 + X1; } return X2; }
+int even(int n) { n = odd(n); return n; }
+int odd(int n) { n = even(n); return n; }
+int g(int X1, int X2) { X1 = X2 + X2; return X1; }
+int h(int X1, int X2, int X3) { X3 = f(X1, 1); X2 = g(X3, X3); }
+int k(int X1, int X2) { X2 = g(X1, X1); X1 = printf(X2); X1 = f(X2 + 1); }
+"""
+
+
+def parse(source):
+    return c_parser.CParser().parse(source)
+
+
+def results(ast, matrix=True):
+    """Result of each function, comparable across runs."""
+    return {name: (matrix and str(relation),
+                   combinations and combinations.valid, inf)
+            for name, (relation, combinations, inf)
+            in Analysis.run(ast, no_save=True).items()}
+
+
+def test_call_graph_components_and_levels():
+    """Mutually recursive functions form one component, and components
+    come after the components they call."""
+    graph = CallGraph(list(parse(SOURCE)))
+    assert graph.callees['h'] == ['f', 'g']
+    assert graph.callees['k'] == ['g', 'f']
+    assert graph.components() == [
+        ['f'], ['even', 'odd'], ['g'], ['h'], ['k']]
+    assert graph.levels() == [[['f'], ['even', 'odd'], ['g']], [['h'], ['k']]]
+
+
+def test_call_is_analyzed_with_summary():
+    """Call of f is replaced by the flow from its arguments to its return
+    value, with fresh deltas, and the choices of f that lead to infinity
+    are excluded."""
+    result = Analysis.run(FUNCTION_CALL, no_save=True)
+    foo, combinations, infinite = result['foo']
+
+    assert not infinite
+    assert str(foo.matrix[0][1]).strip() == \
+        '+p.delta(0,0)+p.delta(1,0)+w.delta(2,0)'
+    assert combinations.valid == [[[0, 1, 2], [2]]]
+    assert list(result.keys()) == ['f', 'foo']
+
+
+def test_call_of_infinite_function_is_infinite():
+    """Assigning the value of an infinite function is infinite."""
+    ast = parse('int foo(int x, int y) { y = f(x, y); }')
+    ast.ext.insert(0, deepcopy(INFINITE_2C.ext[0]))
+    ast.ext[0].decl.name = 'f'
+    assert Analysis.run(ast, no_save=True)['foo'][2]
+
+
+def test_bare_call_uses_summary():
+    """A call whose value is not assigned excludes the choices of the
+    called function, and calling an infinite function is infinite."""
+    assigned = Analysis.run(FUNCTION_CALL, no_save=True)['foo'][1]
+    ast = deepcopy(FUNCTION_CALL)
+    call = ast.ext[1].body.block_items[1]
+    ast.ext[1].body.block_items[1] = call.rvalue
+    foo, combinations, infinite = Analysis.run(ast, no_save=True)['foo']
+
+    assert not infinite
+    assert combinations.valid == assigned.valid == [[[0, 1, 2], [2]]]
+
+    ast = parse('int foo(int x, int y) { f(x, y); }')
+    ast.ext.insert(0, deepcopy(INFINITE_2C.ext[0]))
+    ast.ext[0].decl.name = 'f'
+    assert Analysis.run(ast, no_save=True)['foo'][2]
+
+
+def test_unsupported_calls_are_skipped():
+    """Recursive calls, calls of undefined functions, and calls with
+    expressions as arguments, leave variables unchanged."""
+    result = Analysis.run(parse(SOURCE), no_save=True)
+    even = result['even'][0]
+    k = result['k'][0]
+
+    assert str(even.matrix[0][0]).strip() == '+m'
+    assert k.variables == ['X1', 'X2']
+    assert str(k.matrix[1][0]).strip() == '+o'
+
+
+def test_components_analyzed_in_parallel():
+    """Analysis of independent components in worker processes gives the
+    same results, with either backend."""
+    expected = results(parse(SOURCE))
+    # matrices are printed differently by the two backends
+    choices = results(parse(SOURCE), False)
+    try:
+        workers.use(2)
+        assert results(parse(SOURCE)) == expected
+        backend.use('mdd')
+        assert results(parse(SOURCE), False) == choices
+    finally:
+        backend.use(backend.DEFAULT)
+        workers.use(1)
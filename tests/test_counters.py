@@ -0,0 +1,62 @@
+import pytest
+
+from pymwp import Analysis, Polynomial
+from pymwp import semiring, monomial, mdd
+from pymwp.mdd import ChoiceDiagram, infinity_of
+from pymwp.monomial import Monomial
+from pymwp.counters import Counters
+from pymwp.stats import COLLECTORS
+from .mocks.ast_mocks import INFINITE_2C
+
+
+def test_counters_restore_kernels():
+    """Kernels are unwrapped when counter stops."""
+    prod, init = semiring.prod_mwp, Polynomial.times
+    with Counters():
+        assert monomial.prod_mwp is not prod
+        assert Polynomial.times is not init
+    assert semiring.prod_mwp is prod and monomial.prod_mwp is prod
+    assert Polynomial.times is init
+    assert not COLLECTORS
+
+
+def test_only_one_counter_is_active():
+    with Counters():
+        with pytest.raises(RuntimeError):
+            Counters().start()
+
+
+def test_polynomial_operations_are_counted():
+    p1, p2 = Polynomial('m'), Polynomial('w')
+    with Counters() as counters:
+        p1 * p2
+        p1 + p2 + p2
+    assert counters.counts['times'] == 1
+    assert counters.counts['times_terms'] == 1
+    assert counters.counts['add'] == 2
+    assert counters.counts['add_terms'] == 4
+    assert counters.counts['prod_mwp'] == 1
+
+
+def test_counts_are_deterministic():
+    """Repeated analysis of same function gives same counts."""
+    runs = []
+    for _ in range(2):
+        with Counters() as counters:
+            Analysis.run(INFINITE_2C, no_save=True)
+        runs.append(counters.counts)
+    assert runs[0] == runs[1]
+    assert runs[0]['fixpoint_iterations'] > 0
+    assert runs[0]['matrix_prod_cells'] > 0
+
+
+def test_choice_diagram_terms_are_counted():
+    """Infinite monomials combined into a choice diagram are counted."""
+    poly = Polynomial([Monomial('i', [(0, 0)]), Monomial('m', [(1, 0)]),
+                       Monomial('i', [(2, 1)])])
+    with Counters() as counters:
+        diagram = ChoiceDiagram.of_polynomials(
+            [0, 1, 2], 2, [poly, Polynomial('m')])
+    assert counters.counts['choice_terms'] == 2
+    assert mdd.infinity_of is infinity_of
+    assert not diagram.infinite
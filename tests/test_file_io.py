@@ -1,7 +1,8 @@
 import os
 import json
 
-from pymwp.file_io import default_file_out, save_relation, load_relation
+from pymwp.file_io import default_file_out, save_relation, load_relation, \
+    open_stream, write_relation, iterate_relations
 from pymwp import Relation, Choices
 
 
@@ -71,3 +72,28 @@ def test_load_relation(mocker):
     assert first_poly.scalar == "m"
     assert first_poly.deltas == [(0, 0)]
     assert not infinity
+
+
+def test_stream_relations_round_trip(tmp_path):
+    """Streamed results are written one line per function and can be read
+    back lazily in the same order."""
+    file_name = str(tmp_path / "deep" / "result.ndjson")
+    relation = Relation(['x', 'y'])
+    stream = open_stream(file_name)
+    write_relation(stream, 'foo', (relation, Choices([[[0], [1]]]), False))
+    write_relation(stream, 'bar', (None, None, True))
+    stream.close()
+
+    with open(file_name) as lines:
+        assert len(lines.readlines()) == 2
+
+    results = iterate_relations(file_name)
+    name, (rel, choices, infinity) = next(results)
+    assert name == 'foo'
+    assert rel.variables == ['x', 'y']
+    assert choices.valid == [[[0], [1]]]
+    assert not infinity
+
+    name, (rel, choices, infinity) = next(results)
+    assert name == 'bar'
+    assert rel is None and infinity
@@ -0,0 +1,26 @@
+from pymwp.infinity import InfinityStore
+
+
+def test_store_fuses_all_choices_at_index():
+    """Sequences that differ only by all choices at one index are fused."""
+    store = InfinityStore([((0, 1), (0, 2)), ((0, 1), (1, 2))])
+    store.insert(((0, 1), (2, 2)))
+    assert store.cubes == (((0, 1),),)
+    assert not store.full
+
+
+def test_store_full_when_every_choice_is_infinite():
+    """Fusion of nested cliques detects that every choice is infinite."""
+    store = InfinityStore([((0, 1), (0, 2)), ((0, 1), (1, 2)),
+                           ((0, 1), (2, 2), (0, 3)),
+                           ((0, 1), (2, 2), (1, 3)),
+                           ((0, 1), (2, 2), (2, 3)),
+                           ((1, 1),), ((2, 1),)])
+    assert store.full
+    assert store.cubes == ((),)
+
+
+def test_empty_store():
+    store = InfinityStore()
+    assert store.cubes == ()
+    assert str(store) == 'None'
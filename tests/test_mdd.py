@@ -0,0 +1,199 @@
+import os
+import random
+
+import pytest
+
+from pymwp import Analysis, Monomial, Polynomial, backend
+from pymwp.file_io import parse
+from pymwp.mdd import MANAGER, ChoiceDiagram, MDDPolynomial
+from .budget import ROOT, corpus
+from .mocks.ast_mocks import INFINITE_2C, NOT_INFINITE_2C
+
+
+def random_polynomial(rng):
+    monomials = [Monomial(rng.choice('omwpi'), sorted(
+        [(rng.randrange(3), i) for i in rng.sample(range(4), 2)],
+        key=lambda d: d[1])) for _ in range(rng.randint(1, 4))]
+    return Polynomial('o') + Polynomial(Polynomial.sort_monomials(monomials))
+
+
+def mdd(poly):
+    return MDDPolynomial(poly.list)
+
+
+def test_mdd_matches_list_polynomial():
+    """Sum and product of diagrams are the diagrams of the sum and product
+    of list polynomials."""
+    rng = random.Random(0)
+    for _ in range(200):
+        p1, p2 = random_polynomial(rng), random_polynomial(rng)
+        assert mdd(p1).add(mdd(p2)) == mdd(p1.add(p2))
+        assert mdd(p1).times(mdd(p2)) == mdd(p1.times(p2))
+        assert mdd(p1).equal(mdd(p2)) == p1.equal(p2)
+
+
+def test_mdd_is_canonical():
+    """Equivalent monomial lists give the same node."""
+    p1 = MDDPolynomial([Monomial('m', [(0, 0)]), Monomial('m', [(1, 0)]),
+                        Monomial('m', [(2, 0)])])
+    p2 = MDDPolynomial('m')
+    assert p1 == p2
+    assert p1.size == 1
+
+
+def test_mdd_zero_and_unit():
+    """Unit is neutral for product and zero absorbs it."""
+    p = MDDPolynomial.from_scalars(0, 'm', 'w', 'p')
+    assert p.times(MDDPolynomial('m')) == p
+    assert p.times(MDDPolynomial()) == MDDPolynomial('o')
+    assert str(MDDPolynomial()) == '  +o'
+
+
+def test_mdd_while_correction():
+    """While correction changes p, and w on the diagonal, to infinity."""
+    p = MDDPolynomial.from_scalars(1, 'm', 'w', 'p')
+    off, inf1 = p.while_correction(False)
+    diag, inf2 = p.while_correction(True)
+    assert off == MDDPolynomial.from_scalars(1, 'm', 'w', 'i')
+    assert diag == MDDPolynomial.from_scalars(1, 'm', 'i', 'i')
+    assert inf1 == [((2, 1),)]
+    assert sorted(inf2) == [((1, 1),), ((2, 1),)]
+    assert sorted(diag.eval) == sorted(inf2)
+
+
+def test_mdd_eval_covers_shared_region():
+    """Infinity region common to all choices does not test the index."""
+    p = MDDPolynomial([Monomial('i', [(0, 0), (1, 1)]),
+                       Monomial('i', [(1, 0), (1, 1)]),
+                       Monomial('i', [(2, 0), (1, 1)]),
+                       Monomial('i', [(0, 0), (2, 1)])])
+    assert sorted(p.eval) == [((0, 0), (2, 1)), ((1, 1),)]
+
+
+def test_list_while_correction():
+    """List polynomial is corrected into a new polynomial, as polynomials
+    are shared."""
+    p = Polynomial.from_scalars(1, 'm', 'w', 'p')
+    result, infinite = p.while_correction(True)
+    assert [m.scalar for m in p.list] == ['m', 'w', 'p']
+    assert [m.scalar for m in result.list] == ['m', 'i', 'i']
+    assert infinite == [((1, 1),), ((2, 1),)]
+
+
+@pytest.mark.parametrize('ast', [INFINITE_2C, NOT_INFINITE_2C])
+def test_analysis_with_mdd_backend(ast):
+    """Both backends give the same analysis result."""
+    try:
+        backend.use('mdd')
+        r2, c2, inf2 = Analysis.run(ast, no_save=True)
+    finally:
+        backend.use('list')
+    r1, c1, inf1 = Analysis.run(ast, no_save=True)
+    assert inf1 == inf2
+    if not inf1:
+        for row1, row2 in zip(r1.matrix, r2.matrix):
+            assert [mdd(p) for p in row1] == row2
+        assert c1.valid == c2.valid
+
+
+@pytest.mark.parametrize('name', ['list', 'mdd'])
+def test_analysis_releases_diagrams(name):
+    """Repeated analyses do not grow the unique table, and results keep
+    their diagrams."""
+    try:
+        backend.use(name)
+        expected = str(Analysis.run(NOT_INFINITE_2C, no_save=True)[0])
+        size = len(MANAGER)
+        for _ in range(3):
+            relation = Analysis.run(NOT_INFINITE_2C, no_save=True)[0]
+            Analysis.run(INFINITE_2C, no_save=True)
+            assert str(relation) == expected
+        del relation
+        Analysis.run(NOT_INFINITE_2C, no_save=True)
+        assert len(MANAGER) <= size
+    finally:
+        backend.use('list')
+
+
+def test_release_keeps_polynomials():
+    """Released nodes are forgotten, kept polynomials are renumbered."""
+    mark = MANAGER.mark()
+    kept = MDDPolynomial.from_scalars(0, 'm', 'w', 'p') * \
+        MDDPolynomial.from_scalars(1, 'w', 'm', 'o')
+    expected = str(kept)
+    MDDPolynomial.from_scalars(2, 'p', 'p', 'i') + kept
+    MANAGER.release(mark, [kept, kept])
+    assert len(MANAGER) <= mark + 4
+    assert str(kept) == expected
+    assert kept == MDDPolynomial.from_scalars(0, 'm', 'w', 'p') * \
+        MDDPolynomial.from_scalars(1, 'w', 'm', 'o')
+
+
+def analyze(c_file):
+    """Result of each function of a C file of the corpus."""
+    result = Analysis.run(parse(os.path.join(ROOT, c_file)), no_save=True)
+    return result if isinstance(result, dict) else {'': result}
+
+
+@pytest.mark.parametrize('c_file', corpus())
+def test_backends_give_same_results(c_file):
+    """Both backends give the same choices and infinity, and equivalent
+    matrices, on the example corpus."""
+    expected = analyze(c_file)
+    try:
+        backend.use('mdd')
+        result = analyze(c_file)
+    finally:
+        backend.use(backend.DEFAULT)
+    assert result.keys() == expected.keys()
+    for name, (relation, choices, infinite) in result.items():
+        relation1, choices1, infinite1 = expected[name]
+        assert infinite == infinite1
+        assert (choices and choices.valid) == (choices1 and choices1.valid)
+        if relation is not None:
+            assert relation.variables == relation1.variables
+            assert relation.matrix == [
+                [MDDPolynomial(poly.list) for poly in row]
+                for row in relation1.matrix]
+
+
+def test_unknown_backend():
+    with pytest.raises(ValueError):
+        backend.use('array')
+    assert backend.name() == 'list'
+
+
+def test_choice_diagram_vectors():
+    """Valid choices are the complement of the infinity region, as
+    disjoint vectors."""
+    polys = [Polynomial([Monomial('i', [(0, 0)])]),
+             Polynomial([Monomial('i', [(1, 0)])]),
+             Polynomial([Monomial('i', [(1, 1), (0, 3)])])]
+    diagram = ChoiceDiagram.of_polynomials([0, 1, 2], 4, polys)
+    assert diagram.vectors == [[[2], [0, 2], [0, 1, 2], [0, 1, 2]],
+                               [[2], [1], [0, 1, 2], [1, 2]]]
+    assert diagram.count() == 24
+    assert diagram.is_valid(2, 1)
+    assert not diagram.is_valid(1)
+    assert not diagram.infinite
+
+
+def test_choice_diagram_sample():
+    """Samples are valid and cover all valid choices."""
+    polys = [MDDPolynomial.from_scalars(0, 'i', 'm', 'i'),
+             MDDPolynomial.from_scalars(1, 'm', 'i', 'm')]
+    diagram = ChoiceDiagram.of_polynomials([0, 1, 2], 2, polys)
+    rng = random.Random(0)
+    samples = {tuple(diagram.sample(rng)) for _ in range(50)}
+    assert samples == {(1, 0), (1, 2)}
+    assert diagram.count() == 2
+
+
+def test_choice_diagram_infinite():
+    """When every choice is infinite there are no vectors or samples."""
+    diagram = ChoiceDiagram.of_polynomials(
+        [0, 1, 2], 2, [Polynomial('i')])
+    assert diagram.infinite
+    assert diagram.vectors == []
+    assert diagram.count() == 0
+    assert diagram.sample() is None
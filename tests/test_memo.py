@@ -0,0 +1,100 @@
+from contextlib import nullcontext
+
+from pycparser import c_parser
+
+from pymwp import Analysis
+from pymwp.counters import Counters
+from pymwp.infinity import InfinityStore
+from pymwp.memo import RelationCache
+from pymwp.variables import VariableTable
+
+SOURCE = """
+void foo(int X0, int X1, int X2) {
+    X0 = X1 + X2;
+    while (X0) { X1 = X0 + X0; }
+    if (X0) { X0 = X1 + X2; } else { X0 = X1 + X2; }
+    X0 = X1 + X2;
+    while (X0) { X1 = X0 + X0; }
+    X0 = X2 + X1;
+}
+"""
+
+
+def statements():
+    return c_parser.CParser().parse(SOURCE).ext[0].body.block_items
+
+
+def analyze(nodes, cache=None):
+    """Analyze statements one after the other, with or without cache."""
+    index, store, result = 0, InfinityStore(), []
+    with VariableTable(['X0', 'X1', 'X2']), cache or nullcontext():
+        for node in nodes:
+            index, rel_list, _ = Analysis.compute_relation(index, node, store)
+            result.append(str(rel_list))
+    return index, result, sorted(store.cubes)
+
+
+def test_structural_key():
+    """Statements have the same key iff they have the same structure."""
+    nodes, cache = statements(), RelationCache()
+    keys = [cache.key(node) for node in nodes]
+
+    assert keys[0] == keys[3]
+    assert keys[1] == keys[4]
+    assert keys[0] != keys[5]
+    assert cache.key(nodes[2].iftrue) == cache.key(nodes[2].iffalse)
+
+
+def test_cached_relations_are_relocated():
+    """Repeated statements are served from the cache, with delta indices
+    moved to where they occur, and give the same relations and
+    infinity choices as when they are analyzed again."""
+    nodes = statements()
+    cache = RelationCache(nodes)
+    expected = analyze(statements())
+    actual = analyze(nodes, cache)
+
+    assert actual == expected
+    # the repeated loop
+    assert cache.hits == 1
+    assert 'delta(0,5)' in actual[1][4]
+    assert 'delta(0,1)' not in actual[1][4]
+
+
+def test_analysis_uses_cache(mocker):
+    """Repeated loops of a function body are analyzed once."""
+    function = c_parser.CParser().parse(SOURCE).ext[0]
+    spy = mocker.spy(Analysis, 'while_')
+    Analysis.analyze_function(function)
+
+    assert spy.call_count == 1
+
+
+def test_unique_statements_are_not_cached():
+    """Assignments, and statements that occur once, are analyzed without
+    being cached."""
+    nodes = statements()
+    cache = RelationCache(nodes)
+    analyze(nodes, cache)
+
+    assert cache.key(nodes[0]) not in cache.entries
+    assert cache.key(nodes[2]) not in cache.entries
+    assert cache.key(nodes[1]) in cache.entries
+
+
+def test_cache_saves_work():
+    """Cache hits on repeated loops do less work, and insert the same
+    delta sequences in the infinity store as analysis without cache."""
+    nodes = statements()
+    with Counters() as uncached:
+        expected = analyze(statements())
+    cache = RelationCache(nodes)
+    with Counters() as cached:
+        actual = analyze(nodes, cache)
+
+    assert actual == expected
+    assert cache.hits > 0
+    assert cached.counts['infinity_inserts'] == \
+           uncached.counts['infinity_inserts']
+    assert cached.counts['prod_mwp'] < uncached.counts['prod_mwp']
+    assert cached.counts['matrix_prod'] < uncached.counts['matrix_prod']
@@ -0,0 +1,121 @@
+import random
+import sys
+
+import pytest
+
+from pymwp import Choices, Polynomial, native
+from pymwp import matrix as matrix_utils
+from pymwp.monomial import Monomial
+
+pytestmark = pytest.mark.skipif(
+    not native.available(), reason='native extension is not built')
+
+
+def random_polynomial(rand):
+    """Polynomial of a few monomials over a few choices."""
+    monomials = []
+    for _ in range(rand.randint(0, 4)):
+        indices = rand.sample(range(4), rand.randint(0, 3))
+        monomials.append(Monomial(rand.choice('omwpi'), [
+            (rand.randint(0, 2), index) for index in indices]))
+    return Polynomial(monomials).remove_zeros()
+
+
+def infinite(poly):
+    """Deltas of infinite monomials of a polynomial."""
+    return [tuple(mono.deltas) for mono in poly.list if mono.scalar == 'i']
+
+
+def python(function, *args):
+    """Compute with native kernels disabled."""
+    try:
+        native.use(False)
+        return function(*args)
+    finally:
+        native.use(True)
+
+
+def test_sum_and_product_match_python():
+    """Native sum and product give the same monomials and infinity."""
+    rand = random.Random(1)
+    for _ in range(200):
+        p1, p2 = random_polynomial(rand), random_polynomial(rand)
+        for op in (Polynomial.add, Polynomial.times):
+            expected, actual = python(op, p1, p2), op(p1, p2)
+            assert str(actual) == str(expected)
+            assert actual.infinite == infinite(expected)
+
+
+def test_matrix_products_match_python():
+    """Native matrix products give the same entries."""
+    rand = random.Random(2)
+    size = 5
+    m1, m2 = ([[random_polynomial(rand) for _ in range(size)]
+               for _ in range(size)] for _ in range(2))
+    e1, e2 = ([[random_polynomial(rand) if rand.random() < .5 else None
+                for _ in range(size)] for _ in range(size)] for _ in range(2))
+    rows = range(1, size)
+    for function, args in ((matrix_utils.prod_rows, (m1, m2, rows)),
+                           (matrix_utils.extended_rows, (e1, e2, rows))):
+        expected, actual = python(function, *args), function(*args)
+        assert [[str(p) for p in row] for row in actual] == \
+               [[str(p) for p in row] for row in expected]
+        assert [[p.infinite for p in row] for row in actual] == \
+               [[infinite(p) for p in row] for row in expected]
+
+
+def test_results_own_their_deltas():
+    """Deltas created for results are not kept by the extension."""
+    p1 = Polynomial([Monomial('m', [(0, 999983)])])
+    p2 = Polynomial([Monomial('w')])
+    product = p1.times(p2)
+    rows = matrix_utils.prod_rows([[p1]], [[p2]], range(1))
+    for poly in (product, rows[0][0]):
+        delta = poly.list[0].deltas[0]
+        assert delta == (0, 999983)
+        # referenced by the monomial, `delta` and the argument
+        assert sys.getrefcount(delta) == 3
+
+
+def test_use_disables_kernel():
+    """Kernels are not used once disabled."""
+    try:
+        native.use(False)
+        assert native.kernel() is None
+    finally:
+        native.use(True)
+    assert native.kernel() is not None
+
+
+def random_sequences(rand, choices, index):
+    """Set of delta sequences over distinct indices."""
+    sequences = set()
+    for _ in range(rand.randint(0, 12)):
+        count = rand.randint(1, min(3, index))
+        indices = sorted(rand.sample(range(index), count))
+        sequences.add(tuple((rand.choice(choices), i) for i in indices))
+    return sequences
+
+
+def test_choice_reduction_matches_python():
+    """Native reduction gives the same sets, in the same order, and the
+    same vectors, in the same order."""
+    rand = random.Random(3)
+    for _ in range(300):
+        choices, index = [0, 1, 2], rand.randint(1, 4)
+        inf = random_sequences(rand, choices, index)
+        expected = python(Choices.unique_sequences, inf)
+        actual = Choices.unique_sequences(inf)
+        assert list(actual) == list(expected)
+        python(Choices.reduce_subsequences, choices, expected)
+        Choices.reduce_subsequences(choices, actual)
+        assert list(actual) == list(expected)
+        assert Choices.build_choices(choices, index, actual) == \
+               python(Choices.build_choices, choices, index, expected)
+
+
+def test_choice_vectors_fall_back_to_python():
+    """Choices whose order in a set may differ are built in Python."""
+    inf = {((9, 0),), ((1, 0), (10, 1))}
+    assert Choices.generate([1, 9, 10], 2, inf).valid == \
+           python(Choices.generate, [1, 9, 10], 2, inf).valid
@@ -0,0 +1,95 @@
+import os
+import subprocess
+import sys
+
+import pytest
+
+from pymwp import Polynomial, Relation, RelationList, parallel, workers
+from pymwp import matrix as matrix_utils
+from pymwp.monomial import Monomial
+from pymwp.variables import VariableTable
+
+
+def assignment(target, source, index):
+    """Relation list of target = source, with choice at index."""
+    o, m = Polynomial('o'), Polynomial('m')
+    return RelationList(relation_list=[Relation([source, target], [
+        [m, Polynomial.from_scalars(index, 'm', 'w', 'p')], [o, o]])])
+
+
+def test_pack_and_unpack():
+    """Relation list is the same after encoding and decoding."""
+    poly = Polynomial([Monomial('w', [(0, 0), (2, 7)]), Monomial('i')])
+    rel_list = assignment('X0', 'X1', 0) + RelationList(
+        relation_list=[Relation(['X1'], [[poly]])])
+    assert str(parallel.unpack(parallel.pack(rel_list))) == str(rel_list)
+
+
+def test_compose_tree_matches_sequential_composition():
+    """Composition in worker processes gives the same relations."""
+    variables = ['X0', 'X1', 'X2', 'X3']
+    with VariableTable(variables):
+        chain = [assignment(variables[i % 4], variables[(i + 1) % 4], i)
+                 for i in range(7)]
+        expected = RelationList()
+        for rel_list in chain:
+            expected.composition(rel_list)
+        try:
+            workers.use(2)
+            actual = parallel.compose_tree(chain, chunk=2)
+        finally:
+            workers.use(1)
+    assert str(actual) == str(expected)
+
+
+def test_invalid_jobs():
+    with pytest.raises(ValueError):
+        workers.use(0)
+    assert workers.jobs() == 1
+
+
+def test_matrix_product_by_rows(monkeypatch):
+    """Products computed by rows in worker processes are the same."""
+    variables = ['X0', 'X1', 'X2', 'X3']
+    with VariableTable(variables):
+        r1 = assignment('X0', 'X1', 0).first * assignment('X2', 'X0', 1).first
+        r2 = assignment('X1', 'X2', 2).first * Relation.identity(['X3'])
+        expected = [r1 * r2, Relation(r1.variables, matrix_utils.matrix_prod(
+            r1.matrix, r1.matrix))]
+        monkeypatch.setattr(workers, 'MIN_ROWS', 2)
+        try:
+            workers.use(2)
+            actual = [r1 * r2, Relation(r1.variables, matrix_utils.matrix_prod(
+                r1.matrix, r1.matrix))]
+        finally:
+            workers.use(1)
+    assert [str(r) for r in actual] == [str(r) for r in expected]
+
+
+ROWS_IN_POOL = """
+import time
+from pymwp import Polynomial, workers
+from pymwp import matrix as matrix_utils
+
+workers.use(2)
+# workers start before any shared memory exists
+for task in [workers.pool().submit(time.sleep, .2) for _ in range(2)]:
+    task.result()
+m = [[Polynomial.from_scalars(i, 'm', 'w', 'p') for i in range(4)]
+     for _ in range(4)]
+for _ in range(4):
+    workers.map_rows(matrix_utils.prod_rows, [m, m], 4)
+workers.shutdown()
+"""
+
+
+def test_shared_memory_is_not_reported_leaked():
+    """Workers computing rows leave no shared memory to the resource
+    tracker, which would warn about it at exit."""
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    result = subprocess.run(
+        [sys.executable, '-W', 'error', '-c', ROWS_IN_POOL], cwd=root,
+        env={**os.environ, 'PYTHONWARNINGS': 'error'},
+        capture_output=True, text=True, timeout=60)
+    assert result.returncode == 0, result.stderr
+    assert result.stderr == ''
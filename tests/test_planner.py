@@ -0,0 +1,45 @@
+from pymwp import Polynomial, Relation, RelationList
+from pymwp.planner import compose_chain, footprint, plan
+from pymwp.variables import VariableTable
+
+
+def assignment(target, source, index):
+    """Relation list of target = source, with choice at index."""
+    o, m = Polynomial('o'), Polynomial('m')
+    return RelationList(relation_list=[Relation([source, target], [
+        [m, Polynomial.from_scalars(index, 'm', 'w', 'p')], [o, o]])])
+
+
+def test_plan_composes_small_relations_first():
+    """Relations with common variables are composed before the wide
+    relation that follows them."""
+    wide = RelationList.identity(['X0', 'X1', 'X2', 'X3', 'X4', 'X5'])
+    chain = [assignment('X0', 'X1', 0), assignment('X1', 'X0', 1), wide]
+    split = plan([footprint(rel_list) for rel_list in chain])
+    assert split[0][2] == 1
+
+
+def test_compose_chain_matches_left_fold():
+    """Planned composition gives the same relations as composing one
+    statement at a time."""
+    with VariableTable(['X0', 'X1', 'X2', 'X3']):
+        if_ = assignment('X2', 'X3', 2) + assignment('X3', 'X0', 3)
+        chain = [assignment('X0', 'X1', 0), assignment('X2', 'X3', 1),
+                 if_, assignment('X1', 'X2', 4)]
+        expected = RelationList()
+        for rel_list in chain:
+            expected.composition(rel_list)
+        actual = compose_chain(chain)
+    assert str(actual) == str(expected)
+
+
+def test_footprint_of_scalars_keeps_scalars():
+    """Footprint of a relation without deltas is computed from its
+    scalars, as from its polynomials, without building them."""
+    dense = RelationList(relation_list=[Relation(['X0', 'X1'], [
+        [Polynomial('m'), Polynomial('w')], [Polynomial('o'), Polynomial('m')]
+    ])])
+    scalars = RelationList(relation_list=[Relation(
+        ['X0', 'X1'], scalars=dense.first.scalars)])
+    assert footprint(scalars) == footprint(dense)
+    assert scalars.first._matrix is None
@@ -188,3 +188,61 @@ def test_polynomial_init_shorthand_syntax():
     assert Polynomial('m') == Polynomial([Monomial('m')])
     assert Polynomial('w') == Polynomial([Monomial('w')])
     assert Polynomial('p') == Polynomial([Monomial('p')])
+
+
+def test_polynomial_eval_is_recorded_by_operations():
+    """Sum, product and while correction record infinite monomials."""
+    p1 = Polynomial([Monomial('i', [(0, 0)]), Monomial('m', [(1, 0)])])
+    p2 = Polynomial([Monomial('p', [(1, 1)])])
+    assert (p1 + p2).infinite == [((0, 0),)]
+    assert (p1 * p2).infinite == [((0, 0), (1, 1))]
+    p2, _ = p2.while_correction(False)
+    assert p2.infinite == [((1, 1),)]
+    assert p2.eval == [((1, 1),)]
+
+
+def test_while_correction_does_not_change_shared_monomials():
+    """Correcting a sum does not change the polynomials summed."""
+    p1 = Polynomial([Monomial('m', [(0, 0)])])
+    p2 = Polynomial([Monomial('p', [(1, 0)])])
+    total, _ = (p1 + p2).while_correction(False)
+    assert [m.scalar for m in total.list] == ['m', 'i']
+    assert p2.list[0].scalar == 'p'
+    assert p2.eval == []
+
+
+def test_constant_fast_paths_match_general_product(monkeypatch):
+    """Sum and product with constants give the same polynomials as the
+    general algorithms."""
+    from pymwp import native
+    from pymwp.semiring import KEYS
+    general = [Polynomial([Monomial('w', [(0, 1)]), Monomial('i')]),
+               Polynomial([Monomial('m', [(1, 0)]), Monomial('p', [(0, 1)]),
+                           Monomial('w', [(0, 0), (2, 1)])]),
+               Polynomial([Monomial('i', [(2, 2)])])]
+    pairs = [(Polynomial(a), Polynomial(b)) for a in KEYS for b in KEYS] + \
+            [(Polynomial(a), p) for a in KEYS for p in general] + \
+            [(p, Polynomial(a)) for a in KEYS for p in general]
+    fast = [(str(p1 + p2), str(p1 * p2), (p1 * p2).eval) for p1, p2 in pairs]
+    native.use(False)
+    try:
+        assert fast == [(str(p1 + p2), str(p1 * p2), (p1 * p2).eval)
+                        for p1, p2 in pairs]
+        monkeypatch.setattr(
+            Polynomial, 'constant', property(lambda self: None))
+        assert fast == [(str(p1 + p2), str(p1 * p2), (p1 * p2).eval)
+                        for p1, p2 in pairs]
+    finally:
+        native.use(True)
+
+
+def test_constants_are_shared():
+    """Constant results are shared polynomials, which while correction
+    does not change."""
+    p, w = Polynomial('p'), Polynomial('w')
+    assert (p + w) is (w + p) is Polynomial.of_scalar('p')
+    assert (p * w) is Polynomial.of_scalar('p')
+    corrected, infinite = (p * w).while_correction(True)
+    assert str(corrected) == '  +i' and infinite == [()]
+    assert str(Polynomial.of_scalar('p')) == '  +p'
+    assert Polynomial.of_scalar('p').eval == []
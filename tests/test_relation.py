@@ -1,5 +1,8 @@
-from pymwp import Polynomial, Relation
+from pymwp import Monomial, Polynomial, Relation
+from pymwp.infinity import InfinityStore
+from pymwp.variables import VariableTable
 from pymwp.semiring import ZERO_MWP
+from pymwp import matrix as matrix_utils
 from pymwp.matrix import init_matrix
 
 
@@ -66,3 +69,50 @@ def test_replace_column():
     assert after.matrix[0][0] == after.matrix[2][2] and after.matrix[2][2] != p
     assert after.matrix[1][0] == after.matrix[2][0] == after.matrix[0][2]
     assert after.matrix[0][2] == after.matrix[1][2] and after.matrix[1][2] != p
+
+
+def test_relation_hopeless():
+    """Relation is hopeless when infinity covers every choice."""
+    relation = Relation(['X0', 'X1'], [
+        [Polynomial([Monomial('i', [(0, 0)]), Monomial('m', [(1, 0)])]),
+         Polynomial('o')],
+        [Polynomial('o'), Polynomial([Monomial('i', [(1, 0)])])]])
+    assert not relation.hopeless()
+    assert relation.hopeless(InfinityStore([((2, 0),)]))
+
+
+def test_shared_table_composition_matches_homogenisation():
+    """Relations that share a variable table compose and sum like
+    homogenised relations."""
+    def relations():
+        r1 = Relation.identity(['X0', 'X1', 'X2'])
+        r1.matrix[0][1] = Polynomial([Monomial('w', [(0, 0)]),
+                                      Monomial('i', [(1, 0)])])
+        r2 = Relation.identity(['X3', 'X1'])
+        r2.matrix[1][0] = Polynomial.from_scalars(1, 'm', 'p')
+        return r1, r2
+
+    r1, r2 = relations()
+    expected = [r1 * r2, r2 * r1, r1 + r2]
+    with VariableTable(['X0', 'X1', 'X2', 'X3']) as table:
+        r1, r2 = relations()
+        assert r1.shares_table(r2) and r1.table is table
+        actual = [r1 * r2, r2 * r1, r1 + r2]
+    for exp, act in zip(expected, actual):
+        assert exp.variables == act.variables
+        assert str(exp) == str(act)
+
+
+def test_decomposed_fixpoint_matches_iterated_fixpoint():
+    """Fixpoint computed per strongly connected component is the same as
+    the fixpoint of the whole matrix."""
+    o = Polynomial('o')
+    relation = Relation(['X0', 'X1', 'X2', 'X3'], [
+        [Polynomial('m'), Polynomial.from_scalars(0, 'm', 'w'), o, o],
+        [Polynomial('w'), Polynomial('m'), Polynomial('p'), o],
+        [o, o, Polynomial('m'), Polynomial.from_scalars(1, 'w', 'm')],
+        [o, o, o, Polynomial.from_scalars(2, 'm', 'p')]])
+    assert matrix_utils.components(relation.matrix) == [[0, 1], [2], [3]]
+    expected = relation.iterated_fixpoint()
+    actual = relation.fixpoint()
+    assert str(expected) == str(actual)
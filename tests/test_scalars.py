@@ -0,0 +1,101 @@
+import random
+
+import pytest
+
+from pymwp import Polynomial, Relation, native
+from pymwp import matrix as matrix_utils
+from pymwp.infinity import InfinityStore
+from pymwp.mdd import I
+from pymwp.scalars import ScalarMatrix, row_max
+from pymwp.semiring import KEYS
+
+
+def random_matrix(rand, size):
+    """Matrix of constant polynomials."""
+    return [[Polynomial(rand.choice(KEYS[:-1])) for _ in range(size)]
+            for _ in range(size)]
+
+
+def strings(matrix):
+    return [[str(poly) for poly in row] for row in matrix]
+
+
+@pytest.fixture(params=[True, False], ids=['native', 'python'])
+def kernels(request):
+    """Run with and without native kernels."""
+    try:
+        native.use(request.param)
+        yield
+    finally:
+        native.use(True)
+
+
+def test_row_max():
+    assert row_max(bytes([0, 4, 2, 3]), bytes([1, 3, 2, 4])) == \
+           bytes([1, 4, 2, 4])
+
+
+def test_operations_match_polynomials(kernels):
+    """Product and sum of scalar matrices give the same entries as the
+    product and sum of polynomial matrices."""
+    rand = random.Random(4)
+    for size in range(1, 6):
+        m1, m2 = random_matrix(rand, size), random_matrix(rand, size)
+        s1, s2 = ScalarMatrix.of(m1), ScalarMatrix.of(m2)
+        assert strings((s1 * s2).polynomials()) == \
+               strings(matrix_utils.matrix_prod(m1, m2))
+        assert strings((s1 + s2).polynomials()) == \
+               strings(matrix_utils.matrix_sum(m1, m2))
+
+
+def test_polynomial_with_deltas_is_not_scalar():
+    matrix = [[Polynomial('m'), Polynomial.from_scalars(0, 'm', 'w', 'p')],
+              [Polynomial('o'), Polynomial('m')]]
+    assert ScalarMatrix.of(matrix) is None
+    assert Relation(['X0', 'X1'], matrix).scalars is None
+
+
+def test_relation_switches_to_scalars(kernels):
+    """Relations without deltas are composed as scalars; the result is the
+    same as with polynomials."""
+    rand = random.Random(5)
+    r1 = Relation(['X0', 'X1', 'X2'], random_matrix(rand, 3))
+    r2 = Relation(['X2', 'X3'], random_matrix(rand, 2))
+    er1, er2 = Relation.homogenisation(r1, r2)
+    expected = matrix_utils.matrix_prod(er1.matrix, er2.matrix)
+    assert r1.scalars is not None and r2.scalars is not None
+    product = r1 * r2
+    assert product.scalars is not None
+    assert product.variables == ['X0', 'X1', 'X2', 'X3']
+    assert strings(product.matrix) == strings(expected)
+
+
+def polynomial_closure(matrix):
+    """Sum of powers of a polynomial matrix."""
+    fix = current = matrix_utils.identity_matrix(len(matrix))
+    while True:
+        current = matrix_utils.matrix_prod(current, matrix)
+        total = matrix_utils.matrix_sum(fix, current)
+        if strings(total) == strings(fix):
+            return total
+        fix = total
+
+
+def test_scalar_fixpoint_and_while_correction(kernels):
+    """Fixpoint and while correction of scalars give the same matrix as
+    those of polynomials, and record that every choice is infinite."""
+    matrix = [[Polynomial('m'), Polynomial('w'), Polynomial('o')],
+              [Polynomial('o'), Polynomial('m'), Polynomial('p')],
+              [Polynomial('m'), Polynomial('o'), Polynomial('o')]]
+    expected = polynomial_closure(matrix)
+    fix = Relation(['X0', 'X1', 'X2'], matrix).fixpoint()
+    assert fix.scalars is not None
+    assert strings(fix.matrix) == strings(expected)
+    expected = [[poly.while_correction(i == j)[0]
+                 for j, poly in enumerate(row)]
+                for i, row in enumerate(expected)]
+    store = InfinityStore()
+    fix.while_correction(store)
+    assert strings(fix.matrix) == strings(expected)
+    assert store.node == I
+    assert fix.infinity == I
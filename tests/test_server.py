@@ -0,0 +1,139 @@
+import io
+import json
+import os
+import socket
+import threading
+import time
+
+import pytest
+
+from pymwp import Analysis
+from pymwp.file_io import encode_result, parse
+from pymwp.mdd import MANAGER
+from pymwp.server import Server, METHOD_NOT_FOUND, INVALID_PARAMS, \
+    ANALYSIS_ERROR, PARSE_ERROR
+
+CODE = "int foo(int x, int y){ x = x + y; }"
+
+
+def request(method, params=None, request_id=1):
+    return {'jsonrpc': '2.0', 'id': request_id, 'method': method,
+            'params': params or {}}
+
+
+def test_analyze_code_returns_saved_result_structure():
+    """Result has the same structure as analysis result written to file."""
+    server = Server(use_cpp=False)
+    response = server.handle(request('analyze', {'code': CODE}))
+
+    result = response['result']['foo']
+    assert response['id'] == 1
+    assert result['relation']['variables'] == ['x', 'y']
+    assert result['choices'] == [[[0, 1, 2]]]
+    assert result['infinity'] is False
+
+
+def test_analyze_results_are_cached(mocker):
+    """Analyzing same source twice only runs analysis once."""
+    server = Server(use_cpp=False)
+    spy = mocker.spy(server, 'parse')
+    first = server.handle(request('analyze', {'code': CODE}))
+    second = server.handle(request('analyze', {'code': CODE}, 2))
+
+    assert first['result'] == second['result']
+    assert spy.call_count == 1
+
+    server.handle(request('clear_cache'))
+    server.handle(request('analyze', {'code': CODE}))
+    assert spy.call_count == 2
+
+
+def test_invalid_requests_return_errors():
+    """Server responds with error object and keeps running."""
+    server = Server(use_cpp=False)
+
+    assert server.handle(request('foo'))['error']['code'] == METHOD_NOT_FOUND
+    assert server.handle(request('analyze'))['error']['code'] == \
+           INVALID_PARAMS
+    assert server.handle(request('analyze', {'code': CODE, 'x': 1})
+                         )['error']['code'] == INVALID_PARAMS
+    assert server.handle(request('analyze', {'code': 'int f('})
+                         )['error']['code'] == ANALYSIS_ERROR
+    assert server.running
+
+
+def test_serve_stream_until_shutdown():
+    """Stream serving answers each line and stops on shutdown."""
+    server = Server(use_cpp=False)
+    lines = [json.dumps(request('analyze', {'code': CODE})), 'not json',
+             json.dumps(request('shutdown', request_id=2)),
+             json.dumps(request('analyze', {'code': CODE}, 3))]
+    out = io.StringIO()
+    server.serve_stream(io.StringIO('\n'.join(lines) + '\n'), out)
+
+    responses = [json.loads(line) for line in out.getvalue().splitlines()]
+    assert len(responses) == 3
+    assert 'foo' in responses[0]['result']
+    assert responses[1]['error']['code'] == PARSE_ERROR
+    assert responses[2] == {'jsonrpc': '2.0', 'id': 2, 'result': True}
+
+
+def test_analyze_calls_as_analysis_run():
+    """Calls are analyzed with summaries, as by the command line."""
+    file = 'c_files/implementation_paper/example15_a.c'
+    server = Server()
+    result = server.handle(request('analyze', {'file': file}))['result']
+    expected = Analysis.run(parse(file), no_save=True)
+
+    assert list(result) == ['f', 'foo']
+    assert result['foo']['choices'] == [[[0, 1, 2], [2]]]
+    assert result == {name: encode_result(value)
+                      for name, value in expected.items()}
+
+
+def test_requests_release_diagrams():
+    """Decision diagrams of a request are released after it."""
+    code = 'int foo(int x, int y){ while (x) { x = x + y; y = x * x; } }'
+    server = Server(use_cpp=False)
+    server.handle(request('analyze', {'code': code}))
+    size = len(MANAGER)
+    for _ in range(3):
+        server.handle(request('clear_cache'))
+        server.handle(request('analyze', {'code': code}))
+        assert len(MANAGER) == size
+
+
+def test_socket_path_must_not_be_a_file(tmp_path):
+    """Serving on a path that is not a socket leaves the file alone."""
+    path = tmp_path / 'notes.txt'
+    path.write_text('keep me')
+    with pytest.raises(FileExistsError):
+        Server(use_cpp=False).serve_socket(str(path))
+    assert path.read_text() == 'keep me'
+
+
+def test_stale_socket_is_replaced(tmp_path):
+    """Socket left by an earlier server is replaced, and removed after
+    shutdown."""
+    path = str(tmp_path / 'pymwp.sock')
+    stale = socket.socket(socket.AF_UNIX)
+    stale.bind(path)
+    stale.close()
+
+    server = Server(use_cpp=False)
+    thread = threading.Thread(target=server.serve_socket, args=(path,))
+    thread.start()
+    for _ in range(100):
+        try:
+            client = socket.socket(socket.AF_UNIX)
+            client.connect(path)
+            break
+        except OSError:
+            client.close()
+            time.sleep(.05)
+    with client:
+        client.sendall((json.dumps(request('shutdown')) + '\n').encode())
+        assert json.loads(client.makefile().readline())['id'] == 1
+    thread.join(timeout=10)
+    assert not thread.is_alive()
+    assert not os.path.exists(path)
@@ -0,0 +1,102 @@
+import json
+import sys
+
+from pymwp import Analysis
+from pymwp.__main__ import main
+from pymwp.blocks import BlockRelation
+from pymwp.relation_list import RelationList
+from pymwp.stats import Stats, COLLECTORS, span, timed
+from .mocks.ast_mocks import NOT_INFINITE_2C, INFINITE_2C, FUNCTION_CALL
+
+
+def test_inactive_phases_are_not_recorded():
+    """Marked phases outside of active collector do nothing."""
+    stats = Stats()
+
+    @timed('foo')
+    def foo():
+        return 1
+
+    assert foo() == 1
+    with span('bar'):
+        pass
+    assert stats.phases == {}
+    assert not COLLECTORS
+
+
+def test_nested_phases_count_calls_and_time_once():
+    """Recursive phase is counted on every call."""
+    calls = []
+
+    @timed('rec')
+    def rec(n):
+        calls.append(n)
+        return rec(n - 1) if n > 0 else 0
+
+    with Stats() as stats:
+        rec(3)
+
+    assert stats.phases['rec']['calls'] == 4
+    assert stats.phases['rec']['time'] > 0
+    assert stats.depth['rec'] == 0
+
+
+def test_analysis_records_phases_per_function():
+    """Analysis run records phases of each function."""
+    stats = Stats()
+    Analysis.run(FUNCTION_CALL, no_save=True, stats=stats)
+
+    assert set(stats.functions) == {'f', 'foo'}
+    foo = stats.functions['foo']
+    assert foo['phases']['find_variables']['calls'] == 1
+    assert foo['phases']['compute_relation']['calls'] > 0
+    assert foo['phases']['eval']['calls'] == 1
+    assert foo['matrix_size'] == 2
+    assert not stats.active
+
+
+def test_analysis_saves_stats_next_to_result(tmp_path):
+    """Statistics file is written next to result file."""
+    file_out = str(tmp_path / "result.json")
+    Analysis.run(NOT_INFINITE_2C, file_out, stats=Stats())
+
+    with open(tmp_path / "result.stats.json") as stats_file:
+        data = json.load(stats_file)
+
+    assert data['phases']['save_relation']['calls'] == 1
+    function = data['functions']['foo']
+    assert function['phases']['composition']['calls'] > 0
+    assert function['peak_relations'] >= 1
+    assert function['max_polynomial'] >= 1
+
+
+def test_observe_does_not_assemble_block_matrix():
+    """Observing a block relation reads its size without building its
+    matrix."""
+    relation = BlockRelation(['x', 'y', 'z'])
+    with Stats() as stats:
+        stats.current = Stats.new_function()
+        stats.observe('composition', RelationList(relation_list=[relation]))
+
+    assert stats.current['matrix_size'] == 3
+    assert relation._matrix is None
+
+
+def test_stats_are_printed_without_save(monkeypatch, capsys):
+    """With --no-save, statistics are printed instead of discarded."""
+    monkeypatch.setattr(sys, 'argv', [
+        'pymwp', '--no-save', '--silent', '--stats',
+        'c_files/basics/assign_variable.c'])
+    main()
+
+    data = json.loads(capsys.readouterr().out)
+    assert 'foo' in data['functions']
+
+
+def test_fusion_of_infinite_choices_is_recorded():
+    """Insertion of choices that lead to infinity is the fusion phase."""
+    stats = Stats()
+    Analysis.run(INFINITE_2C, no_save=True, stats=stats)
+
+    phases = stats.functions['foo']['phases']
+    assert phases['fusion']['calls'] > 0
@@ -0,0 +1,50 @@
+import json
+
+from pymwp import Analysis, RelationList
+from pymwp.blocks import BlockRelation
+from pymwp import stats
+from pymwp.trace import Trace
+from .mocks.ast_mocks import INFINITE_2C
+
+
+def test_trace_records_nested_spans(tmp_path):
+    """Trace contains balanced begin/end events of analysis phases."""
+    with Trace() as trace:
+        Analysis.run(INFINITE_2C, no_save=True)
+    file_name = str(tmp_path / 'trace.json')
+    trace.save(file_name)
+
+    with open(file_name) as trace_file:
+        events = json.load(trace_file)['traceEvents']
+
+    stack = []
+    for event in events:
+        if event['ph'] == 'B':
+            stack.append(event['name'])
+        else:
+            assert stack.pop() == event['name']
+    assert not stack
+
+    names = [e['name'] for e in events if e['ph'] == 'B']
+    assert names[0] == 'foo'
+    for span in ['statement', 'while', 'fixpoint_iteration', 'composition']:
+        assert span in names
+
+    compositions = [e for e in events
+                    if e['ph'] == 'E' and e['name'] == 'composition']
+    assert all(e['args']['relations'] >= 1 for e in compositions)
+    assert all(e['args']['matrix_size'] >= 1 for e in compositions)
+    assert events == sorted(events, key=lambda e: e['ts'])
+
+
+def test_trace_does_not_assemble_block_relations():
+    """Annotating a phase reads the size of block relations, not their
+    matrix."""
+    relations = RelationList(['X0', 'X1'])
+    relations.relations = [BlockRelation(['X0', 'X1'])]
+    with Trace() as trace:
+        with stats.span('composition'):
+            pass
+        trace.observe('composition', relations)
+    assert trace.events[-1]['args']['matrix_size'] == 2
+    assert relations.first._matrix is None
@@ -0,0 +1,370 @@
+#!/usr/bin/env python3
+
+"""
+This is a utility script for timing core pymwp kernels in isolation.
+
+USAGE: see docs/utilities.md
+"""
+
+import os
+import sys
+import json
+import time
+import random
+import logging
+import argparse
+import platform
+import statistics
+import subprocess
+
+from os.path import abspath, join, dirname, exists
+
+cwd = abspath(join(dirname(__file__), '../'))  # repository root
+sys.path.insert(0, cwd)
+
+# noinspection PyPep8
+from pymwp import Choices, DeltaGraph, Monomial, Polynomial, Relation  # noqa
+# noinspection PyPep8
+from pymwp.matrix import matrix_prod  # noqa
+
+logger = logging.getLogger(__name__)
+
+SCALARS = ['m', 'w', 'p']
+CHOICES = [0, 1, 2]
+
+
+class Inputs:
+    """Generators of random kernel inputs; seeded, so every run of the
+    benchmark measures the same inputs."""
+
+    def __init__(self, seed):
+        self.rng = random.Random(seed)
+
+    def deltas(self, count, indices):
+        """Deltas at `count` distinct indices, drawn from `indices`."""
+        return [(self.rng.choice(CHOICES), i) for i in
+                sorted(self.rng.sample(range(indices), count))]
+
+    def monomial(self, deltas, indices):
+        return Monomial(self.rng.choice(SCALARS),
+                        self.deltas(deltas, indices))
+
+    def monomials(self, count, deltas=2, indices=8):
+        return [self.monomial(deltas, indices) for _ in range(count)]
+
+    def polynomial(self, size, deltas=2, indices=8):
+        """Sorted polynomial of at most `size` monomials; monomials have
+        equal number of deltas, so none of them absorbs another."""
+        poly = Polynomial(Polynomial.sort_monomials(
+            self.monomials(size, deltas, indices)))
+        return Polynomial('o') + poly
+
+    def matrix(self, size, poly_size):
+        """Matrix with mostly 0-entries and unit diagonal, like the
+        matrices of analyzed programs."""
+        return [[self.polynomial(poly_size) if i == j or
+                 self.rng.random() < 0.3 else Polynomial()
+                 for j in range(size)] for i in range(size)]
+
+    def relation(self, size, poly_size, prefix='x'):
+        return Relation([f'{prefix}{i}' for i in range(size)],
+                        self.matrix(size, poly_size))
+
+    def sequences(self, count, length, indices):
+        """Set of delta sequences, as sequences leading to infinity."""
+        return {tuple(self.deltas(length, indices)) for _ in range(count)}
+
+
+class Case:
+    """Benchmark case: one kernel, at one input size.
+
+    `setup` builds fresh inputs before each measurement, and `run`
+    applies the kernel to them; only `run` is timed.
+    """
+
+    def __init__(self, kernel, size, setup, run):
+        self.kernel = kernel
+        self.size = size
+        self.setup = setup
+        self.run = run
+
+    @property
+    def name(self):
+        return f'{self.kernel}/{self.size}'
+
+    def measure_once(self):
+        """Time kernel once, on fresh inputs."""
+        args = self.setup()
+        start = time.perf_counter()
+        self.run(*args)
+        return time.perf_counter() - start
+
+
+def measure_all(cases_, repeat):
+    """Time cases in `repeat` rounds that each time every case once.
+
+    Machine load changes over seconds; spreading the measurements of each
+    case over the whole run lets its fastest one come from a quiet moment.
+
+    Returns:
+        Fastest and median time of each case, by name.
+    """
+    times = {case.name: [] for case in cases_}
+    for _ in range(repeat):
+        for case in cases_:
+            times[case.name].append(case.measure_once())
+    return {name: {'min': min(t), 'median': statistics.median(t)}
+            for name, t in times.items()}
+
+
+def pairs(items):
+    return list(zip(items[::2], items[1::2]))
+
+
+def cases(seed=0):
+    """Build list of all benchmark cases."""
+    gen = Inputs(seed)
+    batch = 200
+    result = []
+
+    def case(kernel, size, setup, run):
+        result.append(Case(kernel, size, setup, run))
+
+    for n in [2, 8, 32]:
+        monos = gen.monomials(2 * batch, deltas=n, indices=2 * n)
+        case('Monomial.prod', n, lambda m=monos: (pairs(m),),
+             lambda ps: [m1.prod(m2) for m1, m2 in ps])
+        case('Monomial.inclusion', n, lambda m=monos: (pairs(m),),
+             lambda ps: [m1.inclusion(m2) for m1, m2 in ps])
+
+    for n in [4, 8, 12]:
+        polys = [gen.polynomial(n, deltas=3, indices=12) for _ in range(20)]
+        monos = gen.monomials(n * 10, deltas=3, indices=12)
+        case('Polynomial.add', n, lambda p=polys: (pairs(p),),
+             lambda ps: [p1 + p2 for p1, p2 in ps])
+        case('Polynomial.times', n, lambda p=polys: (pairs(p),),
+             lambda ps: [p1 * p2 for p1, p2 in ps])
+        case('Polynomial.sort_monomials', n, lambda m=monos: (m,),
+             lambda m: [Polynomial.sort_monomials(m[i:i + n])
+                        for i in range(0, len(m), n)])
+
+    for n in [4, 8, 12]:
+        m1, m2 = gen.matrix(n, 2), gen.matrix(n, 2)
+        case('matrix_prod', n, lambda a=m1, b=m2: (a, b), matrix_prod)
+
+    for n in [2, 3, 4]:
+        rel = gen.relation(n, 2)
+        case('Relation.fixpoint', n, lambda r=rel: (r,),
+             Relation.fixpoint)
+
+    for n in [4, 16, 64]:
+        r1, r2 = gen.relation(n, 1), gen.relation(n, 1)
+        r2.variables = r2.variables[n // 2:] + \
+            [f'y{i}' for i in range(n // 2)]
+        case('Relation.homogenisation', n, lambda a=r1, b=r2: (a, b),
+             lambda a, b: [Relation.homogenisation(a, b)
+                           for _ in range(batch // n)])
+
+    for n in [4, 8, 12]:
+        inf = gen.sequences(n, 2, 3 * n)
+        case('Choices.build_choices', n,
+             lambda i=inf, k=3 * n: (CHOICES, k, i),
+             Choices.build_choices)
+
+    for n in [2, 4, 6]:
+        tuples = list({tuple(gen.deltas(n, n + 2)) for _ in range(batch)})
+        case('DeltaGraph.insert_tuple', n,
+             lambda t=tuples: (DeltaGraph(), t),
+             lambda dg, ts: [dg.insert_tuple(t) for t in ts])
+
+        def fill(t=tuples):
+            dg = DeltaGraph()
+            for t_ in t:
+                dg.insert_tuple(t_)
+            return dg,
+
+        case('DeltaGraph.fusion', n, fill, DeltaGraph.fusion)
+
+    return result
+
+
+class Benchmark:
+
+    def __init__(self, args):
+        """Initialize benchmark utility"""
+        self.repeat = args.repeat
+        self.history = args.history
+        self.baseline = args.baseline
+        self.threshold = args.threshold
+        self.cases = [c for c in cases(args.seed) if not args.only or
+                      any(o in c.kernel for o in args.only)]
+        self.pad = max([len(c.name) for c in self.cases] or [0])
+
+    def run(self):
+        """Time all cases."""
+        results = measure_all(self.cases, self.repeat)
+        logger.info(f'{"CASE".ljust(self.pad)}  {"MIN":>10}  {"MEDIAN":>10}')
+        for name, result in results.items():
+            logger.info(f'{name.ljust(self.pad)}  '
+                        f'{Benchmark.fmt(result["min"])}  '
+                        f'{Benchmark.fmt(result["median"])}')
+        return results
+
+    def confirm(self, results, names):
+        """Measure cases again, and keep their fastest time overall.
+
+        Arguments:
+            results: results of the run, updated in place
+            names: cases to measure again
+        """
+        again = measure_all(
+            [c for c in self.cases if c.name in names], self.repeat)
+        for name, result in again.items():
+            results[name]['min'] = min(results[name]['min'], result['min'])
+
+    @staticmethod
+    def fmt(seconds):
+        return f'{seconds * 1e3:8.3f}ms'
+
+    @staticmethod
+    def run_info():
+        """Describe the current run."""
+        try:
+            commit = subprocess.check_output(
+                ['git', 'rev-parse', '--short', 'HEAD'], cwd=cwd,
+                stderr=subprocess.DEVNULL, universal_newlines=True).strip()
+        except (OSError, subprocess.CalledProcessError):
+            commit = None
+        return {'time': time.strftime('%Y-%m-%dT%H:%M:%S'),
+                'commit': commit, 'python': platform.python_version(),
+                'machine': platform.machine()}
+
+    def append_history(self, results):
+        """Append results to history file."""
+        history = Benchmark.load(self.history) or []
+        history.append({**Benchmark.run_info(), 'results': results})
+        Benchmark.save(self.history, history)
+
+    def save_baseline(self, results):
+        """Replace baseline with the current results."""
+        Benchmark.save(self.baseline, {
+            **Benchmark.run_info(),
+            'results': {k: v['min'] for k, v in results.items()}})
+        logger.info(f'saved baseline to {self.baseline}')
+
+    def compare(self, results):
+        """Compare results to baseline.
+
+        Cases that seem slower than baseline are measured again first,
+        so that a moment of machine load is not reported as regression.
+
+        Returns:
+            List of case names that are slower than baseline by more
+            than the threshold.
+        """
+        baseline = Benchmark.load(self.baseline)
+        if not baseline:
+            logger.info(f'no baseline at {self.baseline}')
+            return []
+        slower = [name for name, current in results.items()
+                  if name in baseline['results'] and current['min'] >
+                  baseline['results'][name] * (1 + self.threshold)]
+        if slower:
+            self.confirm(results, slower)
+        logger.info(f'\n{"CASE".ljust(self.pad)}  {"BASELINE":>10}  '
+                    f'{"CURRENT":>10}  CHANGE')
+        regressions = []
+        for name, current in results.items():
+            base = baseline['results'].get(name)
+            if not base:
+                continue
+            change = current['min'] / base - 1
+            slower = change > self.threshold
+            if slower:
+                regressions.append(name)
+            logger.info(f'{name.ljust(self.pad)}  {Benchmark.fmt(base)}  '
+                        f'{Benchmark.fmt(current["min"])}  '
+                        f'{change:+7.1%}{" REGRESSION" if slower else ""}')
+        return regressions
+
+    @staticmethod
+    def load(file_name):
+        if not exists(file_name):
+            return None
+        with open(file_name) as infile:
+            return json.load(infile)
+
+    @staticmethod
+    def save(file_name, data):
+        if dirname(file_name) and not exists(dirname(file_name)):
+            os.makedirs(dirname(file_name))
+        with open(file_name, 'w') as outfile:
+            json.dump(data, outfile, indent=2)
+            outfile.write('\n')
+
+
+def main():
+    """Run benchmark using provided args."""
+    setup_logger()
+    args = _args(argparse.ArgumentParser())
+    benchmark = Benchmark(args)
+    results = benchmark.run()
+    if args.save_baseline:
+        benchmark.save_baseline(results)
+        return
+    if args.history:
+        benchmark.append_history(results)
+    regressions = benchmark.compare(results)
+    if regressions:
+        logger.info(f'{len(regressions)} case(s) slower than baseline by '
+                    f'more than {args.threshold:.0%}')
+        sys.exit(1)
+
+
+def setup_logger():
+    """Initialize logger."""
+    logger.setLevel(logging.INFO)
+    logger.addHandler(logging.StreamHandler(sys.stdout))
+
+
+def _args(parser, args=None):
+    """Define available arguments."""
+    parser.add_argument(
+        '--repeat',
+        type=int,
+        default=10,
+        help='measurements per case; fastest one is compared (default: 10)')
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=0.25,
+        help='relative slowdown reported as regression (default: 0.25)')
+    parser.add_argument(
+        '--baseline',
+        default=join(cwd, 'utilities', 'benchmark_baseline.json'),
+        help='baseline file (default: utilities/benchmark_baseline.json)')
+    parser.add_argument(
+        '--history',
+        default=join(cwd, 'profile', 'benchmark_history.json'),
+        help='file where results of each run are appended; empty string '
+             'disables history (default: profile/benchmark_history.json)')
+    parser.add_argument(
+        '--save-baseline',
+        action='store_true',
+        help='replace baseline with results of this run')
+    parser.add_argument(
+        '--only',
+        nargs='+',
+        default=[],
+        help='space separated list of kernels to include ' +
+             '(e.g. --only Polynomial matrix_prod)')
+    parser.add_argument(
+        '--seed',
+        type=int,
+        default=0,
+        help='random seed of generated inputs (default: 0)')
+    return parser.parse_args(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+
+"""
+This is a utility script for generating synthetic C programs.
+
+Generated programs consist of one function whose body is built from
+assignments, `if` statements and `while` loops, according to given
+parameters. They are used to study how analysis cost scales with
+program shape.
+
+USAGE: see docs/utilities.md
+"""
+
+import sys
+import random
+import argparse
+
+from typing import List, NamedTuple
+
+
+class Params(NamedTuple):
+    """Shape of generated program."""
+
+    variables: int = 4
+    """number of variables (function parameters)"""
+
+    assignments: int = 8
+    """total number of assignments"""
+
+    ops: str = '+*-c='
+    """operator mix: each assignment picks one character at random;
+    `+`, `-`, `*` give binary operation, `c` assigns a constant and `=`
+    copies another variable. Repeat a character to make it more likely."""
+
+    if_depth: int = 0
+    """nesting depth of `if` statements"""
+
+    while_depth: int = 0
+    """nesting depth of `while` loops"""
+
+    density: float = 1.0
+    """variable-sharing density, between 0 and 1: fraction of variables
+    that one assignment may read. At 1 any variable may be read; lower
+    values confine reads to variables with nearby names, which gives
+    sparse dependencies."""
+
+    seed: int = 0
+    """random seed; same parameters and seed give same program"""
+
+
+class Generator:
+
+    def __init__(self, params: Params):
+        self.params = params
+        self.rng = random.Random(params.seed)
+        self.names = [f'x{i}' for i in range(max(1, params.variables))]
+        self.window = max(1, round(params.density * len(self.names)))
+
+    def operand(self, target: int) -> str:
+        """Pick variable read by assignment to variable `target`."""
+        offset = self.rng.randrange(self.window) - self.window // 2
+        return self.names[(target + offset) % len(self.names)]
+
+    def assignment(self) -> str:
+        target = self.rng.randrange(len(self.names))
+        op = self.rng.choice(self.params.ops or '+')
+        x = self.names[target]
+        if op == 'c':
+            return f'{x} = {self.rng.randint(0, 9)};'
+        if op == '=':
+            return f'{x} = {self.operand(target)};'
+        return f'{x} = {self.operand(target)} {op} {self.operand(target)};'
+
+    def condition(self) -> str:
+        return self.rng.choice(self.names)
+
+    def block(self, count: int, if_depth: int, while_depth: int) \
+            -> List[str]:
+        """Generate statements containing `count` assignments, with
+        nested `if` and `while` statements of given depths.
+
+        One nested statement takes half of the assignments, if there
+        are any left; the rest are placed before and after it.
+        """
+        if count <= 0 or (if_depth <= 0 and while_depth <= 0):
+            return [self.assignment() for _ in range(count)]
+        inner = max(1, count // 2)
+        before = self.rng.randint(0, count - inner)
+        after = count - inner - before
+        # alternate if and while so that both depths are reached
+        use_while = while_depth > 0 and (if_depth <= 0 or
+                                         while_depth >= if_depth)
+        if use_while:
+            nested = [f'while ({self.condition()}) {{',
+                      *Generator.indent(self.block(
+                          inner, if_depth, while_depth - 1)), '}']
+        else:
+            then_count = max(1, inner // 2) if inner > 1 else inner
+            else_count = inner - then_count
+            nested = [f'if ({self.condition()}) {{',
+                      *Generator.indent(self.block(
+                          then_count, if_depth - 1, while_depth))]
+            if else_count:
+                nested += ['} else {', *Generator.indent(self.block(
+                    else_count, if_depth - 1, while_depth))]
+            nested += ['}']
+        return [self.assignment() for _ in range(before)] + nested + \
+            [self.assignment() for _ in range(after)]
+
+    @staticmethod
+    def indent(lines: List[str]) -> List[str]:
+        return ['    ' + line for line in lines]
+
+    def program(self) -> str:
+        """Generate C program."""
+        params = ', '.join(f'int {x}' for x in self.names)
+        body = self.block(self.params.assignments, self.params.if_depth,
+                          self.params.while_depth)
+        header = ' '.join(f'{k}={v}' for k, v in
+                          self.params._asdict().items())
+        return '\n'.join([
+            f'/* generated: {header} */', '',
+            f'int foo({params}) {{', *Generator.indent(body), '}', ''])
+
+
+def generate(params: Params) -> str:
+    """Generate C program of given shape.
+
+    Arguments:
+        params: program shape
+
+    Returns:
+        C source code.
+    """
+    return Generator(params).program()
+
+
+def add_params_args(parser):
+    """Define arguments that set program shape."""
+    defaults = Params()
+    parser.add_argument(
+        '--variables', type=int, default=defaults.variables,
+        help=f'number of variables (default: {defaults.variables})')
+    parser.add_argument(
+        '--assignments', type=int, default=defaults.assignments,
+        help=f'number of assignments (default: {defaults.assignments})')
+    parser.add_argument(
+        '--ops', default=defaults.ops,
+        help='operator mix, characters of +-*c= (default: '
+             f'{defaults.ops})')
+    parser.add_argument(
+        '--if-depth', type=int, default=defaults.if_depth,
+        help=f'nesting depth of if (default: {defaults.if_depth})')
+    parser.add_argument(
+        '--while-depth', type=int, default=defaults.while_depth,
+        help=f'nesting depth of while (default: {defaults.while_depth})')
+    parser.add_argument(
+        '--density', type=float, default=defaults.density,
+        help=f'variable-sharing density (default: {defaults.density})')
+    parser.add_argument(
+        '--seed', type=int, default=defaults.seed,
+        help=f'random seed (default: {defaults.seed})')
+
+
+def params_of(args) -> Params:
+    return Params(**{k: getattr(args, k) for k in Params._fields})
+
+
+def main():
+    """Print generated program."""
+    parser = argparse.ArgumentParser()
+    add_params_args(parser)
+    sys.stdout.write(generate(params_of(parser.parse_args())))
+
+
+if __name__ == '__main__':
+    main()
@@ -7,19 +7,27 @@ USAGE: see docs/utilities.md
 """
 
 import os
-import asyncio
+import sys
+import csv
+import json
 import pstats
+import cProfile
 import logging
 import argparse
 import subprocess
 import signal
+import threading
 import time
+import tracemalloc
+
+from concurrent.futures import ThreadPoolExecutor
 
 from os import listdir, makedirs, remove
 from os.path import abspath, join, dirname, basename, splitext, exists, isfile
 
 logger = logging.getLogger(__name__)
 cwd = abspath(join(dirname(__file__), '../'))  # repository root
+SUMMARY = 'summary'  # file name of results summary, without extension
 
 
 class Profiler:
@@ -37,6 +45,9 @@ class Profiler:
         self.divider_len = 72
         self.no_external = args.no_external
         self.callers = args.callers
+        self.workers = max(1, args.workers)
+        self.tracemalloc = args.tracemalloc
+        self.results = []
 
     @property
     def file_count(self):
@@ -91,9 +102,10 @@ class Profiler:
         """Remove temporary files from output directory."""
         # for all files in output directory
         for f in [join(self.output, f) for f in listdir(self.output)]:
-            # must be a file, not txt file, and not .gitignore
+            # must be a file, not txt file, summary, or .gitignore
             clean_it = isfile(join(self.output, f)) \
                        and '.txt' not in f \
+                       and not basename(f).startswith(SUMMARY) \
                        and self.ignore not in f
             if clean_it:
                 remove(f)
@@ -118,15 +130,16 @@ class Profiler:
                         .print_callers(10)
             remove(out_file)
 
-    @staticmethod
-    def build_cmd(file_in, file_out):
+    def build_cmd(self, file_in, file_out):
         """Build cProfile command"""
-        return ' '.join([
-            'python3 -m cProfile',
-            f'-o {file_out}',
-            '-m pymwp --no-save --silent',
-            file_in
-        ])
+        if self.tracemalloc:
+            # run analysis through this script to also trace allocations
+            cmd = [sys.executable, abspath(__file__), '--child',
+                   str(self.tracemalloc), file_out]
+        else:
+            cmd = [sys.executable, '-m', 'cProfile', '-o', file_out,
+                   '-m', 'pymwp']
+        return cmd + ['--no-save', '--silent', file_in]
 
     @staticmethod
     def get_loc(file_in):
@@ -138,35 +151,42 @@ class Profiler:
         self.pre_log()
         self.ensure_output_dir()
         self.start_time = time.monotonic()
-        for file in sorted(self.file_list):
-            asyncio.run(self.profile_file(file))
+        with ThreadPoolExecutor(max_workers=self.workers) as executor:
+            self.results = list(executor.map(
+                self.profile_file, sorted(self.file_list)))
         self.end_time = time.monotonic()
         self.clear_temp_files()
+        self.write_summary()
         self.post_log()
 
-    async def profile_file(self, c_file):
+    def profile_file(self, c_file):
         """Profile single C file"""
         file_name = Profiler.filename_only(c_file)
         out_file = join(self.output, file_name)
-        cmd = Profiler.build_cmd(c_file, out_file)
+        cmd = self.build_cmd(c_file, out_file)
         loc = Profiler.get_loc(c_file)
 
-        timeout = False
         start_time = time.monotonic()
         proc = subprocess.Popen(
-            [cmd], cwd=cwd, shell=True,
-            stdout=subprocess.PIPE,
-            stderr=subprocess.PIPE
+            cmd, cwd=cwd,
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL
         )
-        try:
-            proc.communicate(timeout=self.timeout)
-            end_time = time.monotonic()
-        except subprocess.TimeoutExpired:
-            end_time = time.monotonic()
-            proc.send_signal(signal.SIGINT)  # raise stop signal
-            time.sleep(2)  # give some time to terminate to capture stats
-            proc.kill()  # now force kill it
-            timeout = True
+        # on timeout: raise stop signal, then give some time to
+        # terminate to capture stats, then force kill it
+        timers = [threading.Timer(self.timeout, proc.send_signal,
+                                  [signal.SIGINT]),
+                  threading.Timer(self.timeout + 2, proc.kill)]
+        for timer in timers:
+            timer.start()
+        # wait4 reaps the child and reports its resource usage
+        _, status, usage = os.wait4(proc.pid, 0)
+        end_time = time.monotonic()
+        for timer in timers:
+            timer.cancel()
+        proc.returncode = os.WEXITSTATUS(status) \
+            if os.WIFEXITED(status) else -os.WTERMSIG(status)
+        timeout = end_time - start_time >= self.timeout
 
         if timeout:
             message = 'timeout'
@@ -176,17 +196,42 @@ class Profiler:
             message = 'error'
         self.write_stats(out_file)
 
+        result = {'file': c_file, 'loc': loc, 'result': message,
+                  'time': round(end_time - start_time, 3),
+                  'max_rss_kb': usage.ru_maxrss}
+        mem_file = out_file + '.mem.txt'
+        if self.tracemalloc and exists(mem_file):
+            with open(mem_file) as mem:
+                result['top_allocation'] = mem.readline().strip()
+
         logger.info(f'{file_name.ljust(self.pad)}... '
                     f'{message.ljust(7)} | {str(loc).ljust(5)} | ' +
-                    f'{(end_time - start_time):.2f}s')
+                    f'{(end_time - start_time):.2f}s | ' +
+                    f'{usage.ru_maxrss / 1024:.1f}MB')
+        return result
+
+    def write_summary(self):
+        """Write results of all files as CSV and JSON."""
+        fields = ['file', 'loc', 'result', 'time', 'max_rss_kb']
+        if self.tracemalloc:
+            fields.append('top_allocation')
+        with open(join(self.output, SUMMARY + '.csv'), 'w',
+                  newline='') as stream:
+            writer = csv.DictWriter(stream, fieldnames=fields)
+            writer.writeheader()
+            writer.writerows(self.results)
+        with open(join(self.output, SUMMARY + '.json'), 'w') as stream:
+            json.dump({'total_time': round(self.total_time, 3),
+                       'workers': self.workers,
+                       'files': self.results}, stream, indent=2)
 
     def pre_log(self):
         """Print info before running profiler."""
         self.__log(f'Profiling {self.file_count} C files... ' +
-                   f'(limit: {self.timeout} sec)')
+                   f'(limit: {self.timeout} sec, workers: {self.workers})')
         logger.info(f'{"EXAMPLE".ljust(self.pad + 4)}'
                     f'{"RESULT".ljust(7)} '
-                    f'| LINES | TIME  ')
+                    f'| LINES | TIME  | MAX RSS')
 
     def post_log(self):
         """Print info after running profiler."""
@@ -198,8 +243,37 @@ class Profiler:
         logger.info(f'\n{divider}\n{msg}\n{divider}')
 
 
+def child(top, out_file, pymwp_args):
+    """Run cProfile and tracemalloc on analysis; write cProfile stats to
+    out_file and top allocating lines to out_file.mem.txt."""
+    sys.path.insert(0, cwd)
+    from pycparser import c_parser
+    from pymwp.__main__ import main as pymwp_main
+    c_parser.CParser()  # load parser tables before tracing
+    sys.argv = ['pymwp'] + pymwp_args
+    tracemalloc.start()
+    profile = cProfile.Profile()
+    profile.enable()
+    try:
+        pymwp_main()
+    finally:
+        profile.disable()
+        snapshot = tracemalloc.take_snapshot().filter_traces([
+            tracemalloc.Filter(False, '<frozen importlib._bootstrap>'),
+            tracemalloc.Filter(False,
+                               '<frozen importlib._bootstrap_external>')])
+        tracemalloc.stop()
+        profile.dump_stats(out_file)
+        with open(out_file + '.mem.txt', 'w') as stream:
+            for stat in snapshot.statistics('lineno')[:top]:
+                stream.write(f'{stat}\n')
+
+
 def main():
     """Run profiler using provided args."""
+    if sys.argv[1:2] == ['--child']:
+        child(int(sys.argv[2]), sys.argv[3], sys.argv[4:])
+        return
     setup_logger()
     args = _args(argparse.ArgumentParser())
     Profiler(args.in_, args.out, args).run()
@@ -272,6 +346,19 @@ def _args(parser, args=None):
         action='store_true',
         help="include caller stats"
     )
+    parser.add_argument(
+        '--workers',
+        type=int,
+        default=os.cpu_count() or 1,
+        help='number of files to profile concurrently ' +
+             '(default: number of CPUs)')
+    parser.add_argument(
+        '--tracemalloc',
+        type=int,
+        default=0,
+        metavar='N',
+        help='record N top allocating source lines of each execution ' +
+             'with tracemalloc (slows down analysis)')
     return parser.parse_args(args)
 
 
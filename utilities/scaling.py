@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+
+"""
+This is a utility script for measuring how analysis time and memory scale
+with the shape of analyzed programs.
+
+It generates synthetic programs (see generator.py) while varying one
+parameter, analyzes each program in a separate process, and fits
+polynomial and exponential curves to the analysis times reported by
+the child's statistics (`pymwp --stats`), so that interpreter startup
+and parsing do not flatten the curves.
+
+USAGE: see docs/utilities.md
+"""
+
+import os
+import sys
+import json
+import math
+import time
+import signal
+import logging
+import argparse
+import tempfile
+import threading
+import statistics
+import subprocess
+
+from os.path import abspath, join, dirname, exists
+
+from generator import Params, generate, add_params_args, params_of
+
+logger = logging.getLogger(__name__)
+cwd = abspath(join(dirname(__file__), '../'))  # repository root
+
+
+def analysis_time(stats_file):
+    """Total analysis time of functions, read from child statistics.
+
+    This excludes interpreter startup, imports, pre-processing and
+    parsing, which do not depend on the shape of analyzed functions.
+
+    Arguments:
+        stats_file: statistics file written by `pymwp --stats`
+
+    Returns:
+        Analysis time in seconds, or `None` if statistics are missing.
+    """
+    if not exists(stats_file):
+        return None
+    with open(stats_file) as infile:
+        functions = json.load(infile)['functions']
+    return sum(func['time'] for func in functions.values())
+
+
+def measure(c_file, timeout):
+    """Analyze C file in a child process.
+
+    Arguments:
+        c_file: path to C file
+        timeout: seconds before the child is killed
+
+    Returns:
+        Tuple of analysis time in seconds, wall time of the child in
+        seconds, peak resident memory in KiB and status: `ok`, `error`
+        or `timeout`.
+    """
+    file_out = os.path.splitext(c_file)[0] + '.json'
+    stats_file = os.path.splitext(file_out)[0] + '.stats.json'
+    start = time.monotonic()
+    proc = subprocess.Popen(
+        [sys.executable, '-m', 'pymwp', '--silent', '--stats',
+         '--out', file_out, c_file],
+        cwd=cwd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    timer = threading.Timer(timeout, os.kill, [proc.pid, signal.SIGKILL])
+    timer.start()
+    try:
+        _, status, usage = os.wait4(proc.pid, 0)
+    finally:
+        timer.cancel()
+    proc.returncode = status  # reaped by wait4
+    elapsed = time.monotonic() - start
+    if os.WIFSIGNALED(status) and os.WTERMSIG(status) == signal.SIGKILL:
+        result = 'timeout'
+    else:
+        result = 'ok' if os.WEXITSTATUS(status) == 0 else 'error'
+    analyzed = analysis_time(stats_file) if result == 'ok' else None
+    if analyzed is None:
+        analyzed, result = elapsed, 'error' if result == 'ok' else result
+    return analyzed, elapsed, usage.ru_maxrss, result
+
+
+def fit(xs, ys):
+    """Least squares line through points.
+
+    Returns:
+        Slope, intercept and coefficient of determination.
+    """
+    n = len(xs)
+    mean_x, mean_y = sum(xs) / n, sum(ys) / n
+    sxx = sum((x - mean_x) ** 2 for x in xs)
+    sxy = sum((x - mean_x) * (y - mean_y) for x, y in zip(xs, ys))
+    syy = sum((y - mean_y) ** 2 for y in ys)
+    slope = sxy / sxx if sxx else 0
+    intercept = mean_y - slope * mean_x
+    r2 = (sxy * sxy) / (sxx * syy) if sxx and syy else 1.0
+    return slope, intercept, r2
+
+
+def fit_curves(points):
+    """Fit scaling curves to (parameter value, time) points.
+
+    - polynomial: $t = a \\cdot x^k$, fitted on $\\log t$ vs. $\\log x$
+    - exponential: $t = a \\cdot b^x$, fitted on $\\log t$ vs. $x$
+
+    Returns:
+        Dictionary of fitted models and name of the better fitting one,
+        or `None` if there are not enough points.
+    """
+    points = [(x, t) for x, t in points if x > 0 and t > 0]
+    if len(points) < 3:
+        return None
+    xs, ts = [x for x, _ in points], [math.log(t) for _, t in points]
+    k, log_a, r2_poly = fit([math.log(x) for x in xs], ts)
+    log_b, log_a2, r2_exp = fit(xs, ts)
+    return {
+        'polynomial': {'a': math.exp(log_a), 'k': k, 'r2': r2_poly},
+        'exponential': {'a': math.exp(log_a2), 'b': math.exp(log_b),
+                        'r2': r2_exp},
+        'best': 'exponential' if r2_exp > r2_poly else 'polynomial'}
+
+
+class Sweep:
+
+    def __init__(self, args):
+        """Initialize parameter sweep"""
+        self.base = params_of(args)
+        self.param = args.param
+        self.values = args.values
+        self.samples = args.samples
+        self.timeout = args.timeout
+        self.out = args.out
+        self.keep = args.keep
+        self.results = []
+
+    def programs(self, value):
+        """Generate sample programs for one parameter value."""
+        for sample in range(self.samples):
+            params = self.base._replace(**{
+                self.param: value, 'seed': self.base.seed + sample})
+            yield params, generate(params)
+
+    def run(self):
+        """Measure all parameter values and fit curves."""
+        logger.info(f'{self.param.ljust(12)} {"TIME":>9} {"WALL":>9} '
+                    f'{"MAX RSS":>9} STATUS')
+        with tempfile.TemporaryDirectory() as tmp:
+            work = self.keep or tmp
+            if not exists(work):
+                os.makedirs(work)
+            kind = type(getattr(self.base, self.param))
+            for value in self.values:
+                self.run_value(kind(value), work)
+        fits = fit_curves([(float(r['value']), r['time'])
+                           for r in self.results if r['status'] == 'ok'])
+        self.report(fits)
+        if self.out:
+            with open(self.out, 'w') as outfile:
+                json.dump({'base': self.base._asdict(), 'param': self.param,
+                           'results': self.results, 'fit': fits},
+                          outfile, indent=2)
+            logger.info(f'saved results to {self.out}')
+
+    def run_value(self, value, work):
+        times, walls, memory, statuses = [], [], [], []
+        for params, code in self.programs(value):
+            c_file = join(work, f'{self.param}_{value}_{params.seed}.c')
+            with open(c_file, 'w') as source:
+                source.write(code)
+            analyzed, elapsed, rss, status = measure(c_file, self.timeout)
+            times.append(analyzed)
+            walls.append(elapsed)
+            memory.append(rss)
+            statuses.append(status)
+        status = 'ok' if set(statuses) == {'ok'} else \
+            'timeout' if 'timeout' in statuses else 'error'
+        result = {'value': value, 'time': statistics.median(times),
+                  'wall_time': statistics.median(walls),
+                  'max_rss_kb': max(memory), 'status': status,
+                  'samples': len(times)}
+        self.results.append(result)
+        logger.info(f'{str(value).ljust(12)} {result["time"]:8.3f}s '
+                    f'{result["wall_time"]:8.2f}s '
+                    f'{result["max_rss_kb"] / 1024:7.1f}MB {status}')
+
+    @staticmethod
+    def report(fits):
+        if not fits:
+            logger.info('not enough measurements to fit curves')
+            return
+        poly, exp = fits['polynomial'], fits['exponential']
+        logger.info(f'polynomial:  t = {poly["a"]:.3g} * x^{poly["k"]:.2f}'
+                    f'   (r2 = {poly["r2"]:.3f})')
+        logger.info(f'exponential: t = {exp["a"]:.3g} * {exp["b"]:.3f}^x'
+                    f'   (r2 = {exp["r2"]:.3f})')
+        logger.info(f'best fit: {fits["best"]}')
+
+
+def main():
+    """Run parameter sweep using provided args."""
+    setup_logger()
+    args = _args(argparse.ArgumentParser())
+    Sweep(args).run()
+
+
+def setup_logger():
+    """Initialize logger."""
+    logger.setLevel(logging.INFO)
+    logger.addHandler(logging.StreamHandler(sys.stdout))
+
+
+def _args(parser, args=None):
+    """Define available arguments."""
+    add_params_args(parser)
+    parser.add_argument(
+        'param',
+        choices=[f for f in Params._fields if f != 'ops' and f != 'seed'],
+        help='program parameter to vary')
+    parser.add_argument(
+        'values',
+        nargs='+',
+        type=float,
+        help='values of the varied parameter')
+    parser.add_argument(
+        '--samples',
+        type=int,
+        default=3,
+        help='programs generated per value, with consecutive seeds; '
+             'median time is reported (default: 3)')
+    parser.add_argument(
+        '--timeout',
+        type=int,
+        default=60,
+        help='max. seconds for one analysis (default: 60)')
+    parser.add_argument(
+        '--out',
+        help='JSON file where to write measurements and fitted curves')
+    parser.add_argument(
+        '--keep',
+        help='directory where to keep generated programs')
+    return parser.parse_args(args)
+
+
+if __name__ == '__main__':
+    main()